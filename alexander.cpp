@@ -0,0 +1,966 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <numeric>
+
+#include "alexander.hpp"
+#include "contract.hpp"
+#include "fixed_matrix.hpp"
+#include "modular.hpp"
+#include "parallel.hpp"
+
+namespace
+{
+    __extension__ typedef __int128 int128;
+
+    // Returns an upper bound for log2 of the sum of the absolute values of the
+    // coefficients of det(M - t M*). Expanding the determinant as a sum over
+    // permutations shows that this sum is bounded by the product of the row
+    // sums of |M| + |M*|. Returns a negative value if the polynomial is zero
+    // because of a zero row.
+    double coefficient_bits(square_matrix<int> const & sm)
+    {
+        double bits = 0;
+        for (std::size_t i = 0; i != sm.dim(); ++i)
+        {
+            double row_sum = 0;
+            for (std::size_t j = 0; j != sm.dim(); ++j)
+                row_sum += std::abs(sm(i, j)) + std::abs(sm(j, i));
+
+            if (row_sum == 0) { return -1; }
+            bits += std::log2(row_sum);
+        }
+        return bits;
+    }
+
+    double coefficient_bits(sparse_matrix<int> const & sm)
+    {
+        std::vector<double> row_sums(sm.rows(), 0);
+        for (std::size_t i = 0; i != sm.rows(); ++i)
+        {
+            for (std::size_t k = sm.row_begin(i); k != sm.row_end(i); ++k)
+            {
+                row_sums[i] += std::abs(sm.value(k));
+                row_sums[sm.col(k)] += std::abs(sm.value(k));
+            }
+        }
+
+        double bits = 0;
+        for (double row_sum : row_sums)
+        {
+            if (row_sum == 0) { return -1; }
+            bits += std::log2(row_sum);
+        }
+        return bits;
+    }
+
+    // Returns the list of primes modulo which the coefficients are computed.
+    // Every prime exceeds 2^61; one extra bit accounts for the sign.
+    std::vector<std::uint64_t> primes_for(double coefficient_bits)
+    {
+        return large_primes(coefficient_bits < 0 ? 1 : static_cast<std::size_t>(coefficient_bits + 1) / 61 + 1);
+    }
+
+    // Converts the mixed-radix "digits" (with respect to the radices
+    // "primes", least significant first) of an integer v modulo the product P
+    // of the primes to the symmetric representative of v in (-P/2, P/2).
+    bigint symmetric_value(std::vector<std::uint64_t> digits, std::vector<std::uint64_t> const & primes)
+    {
+        std::size_t const n = primes.size();
+
+        // The top digit decides the sign, since |v| is much less than P/2.
+        bool const negative = digits[n - 1] > primes[n - 1] / 2;
+
+        // For negative values, the digits of P - 1 - v are the complements.
+        if (negative)
+            for (std::size_t k = 0; k != n; ++k) { digits[k] = primes[k] - 1 - digits[k]; }
+
+        bigint value;
+        for (std::size_t k = n; k-- != 0; )
+        {
+            value *= static_cast<long int>(primes[k]);
+            value += static_cast<long int>(digits[k]);
+        }
+
+        return negative ? -value - 1 : value;
+    }
+
+    // Stores f(t) = det(M - t M*) in values[t] for the points t in [first,
+    // last), computed by exact elimination in the integral type T. The matrix
+    // type M is either square_matrix<T> or a fixed_square_matrix<T, N>;
+    // "work" is the elimination workspace.
+    template <typename T, typename M>
+    void evaluate_range(M const & am, M & work, std::size_t first, std::size_t last, scratch_vector<T> & values)
+    {
+        for (std::size_t i = first; i != last; ++i)
+        {
+            T const t = static_cast<long int>(i);
+            work.assign(am + am.transposed() * -t);
+            values[i] = work.determinant_in_place();
+        }
+    }
+
+    // Selects the fixed-size matrix type of dimension sm.dim() <= N.
+    template <typename T, std::size_t N = max_fixed_dim>
+    struct fixed_evaluation
+    {
+        static scratch_vector<T> run(square_matrix<int> const & sm)
+        {
+            if (sm.dim() != N) { return fixed_evaluation<T, N - 1>::run(sm); }
+
+            fixed_square_matrix<T, N> const am(sm);
+            fixed_square_matrix<T, N> work;
+            scratch_vector<T> values(N + 1);
+
+            arena::suspend heap;
+            evaluate_range(am, work, 0, N + 1, values);
+            return values;
+        }
+    };
+
+    template <typename T>
+    struct fixed_evaluation<T, 0>
+    {
+        static scratch_vector<T> run(square_matrix<int> const &)
+        {
+            return scratch_vector<T>(1, T(1));
+        }
+    };
+
+    // Small matrices, which are by far the most common, use fixed-size
+    // matrices that require no allocation, and are too quick to be worth
+    // distributing across threads. Larger ones are evaluated in parallel (see
+    // parallel.hpp), with one workspace per thread.
+    template <typename T>
+    scratch_vector<T> evaluate(square_matrix<int> const & sm)
+    {
+        if (sm.dim() <= max_fixed_dim) { return fixed_evaluation<T>::run(sm); }
+
+        square_matrix<T> const am(sm);
+        scratch_vector<T> values(sm.dim() + 1);
+
+        // The eliminations allocate and release their temporaries (if T
+        // allocates at all) once per point.
+        arena::suspend heap;
+        parallel_for(values.size(), [&](std::size_t first, std::size_t last)
+        {
+            square_matrix<T> work(sm.dim());
+            evaluate_range(am, work, first, last, values);
+        });
+        return values;
+    }
+
+    template <typename T>
+    scratch_vector<double> evaluate_as_double(square_matrix<int> const & sm)
+    {
+        scratch_vector<T> values = evaluate<T>(sm);
+        scratch_vector<double> result;
+        result.reserve(values.size());
+        for (T const & v : values) { result.push_back(static_cast<double>(v)); }
+        return result;
+    }
+
+    // The factorization of the Vandermonde matrix at the points 0, 1, ...,
+    // d. It depends only on d, so it is computed once per dimension and
+    // shared by all threads. Beyond about d = 20 the solution is too
+    // inaccurate to be of use anyway, so only the factorizations of small
+    // dimensions are kept, and the cache cannot grow without bound.
+    std::size_t const max_cached_vandermonde = 32;
+
+    std::shared_ptr<lu_factorization<double> const> vandermonde_factorization(std::size_t d)
+    {
+        auto const factorize = [d]()
+        {
+            scratch_vector<double> points(d + 1);
+            std::iota(points.begin(), points.end(), 0);
+            return std::make_shared<lu_factorization<double> const>(vandermonde<double>(d + 1, points));
+        };
+
+        if (d > max_cached_vandermonde) { return factorize(); }
+
+        static std::mutex mutex;
+        static std::shared_ptr<lu_factorization<double> const> cache[max_cached_vandermonde + 1];
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<lu_factorization<double> const> & entry = cache[d];
+        if (!entry) { entry = factorize(); }
+        return entry;
+    }
+
+    // Interpolates the values f(0), f(1), ..., f(d) of a polynomial f with
+    // integral coefficients in the type T, which is either integral or a
+    // field in which 1, 2, ..., d are invertible, and returns the coefficients
+    // of f in reverse order (i.e. those of t^d f(1/t)).
+    //
+    // We compute the Newton form f(t) = a_0 + t (a_1 + (t - 1) (a_2 + ...)),
+    // whose coefficients a_k = Delta^k f(0) / k! are integers, and then expand
+    // the nested products from the inside out.
+    template <typename T, typename A>
+    std::vector<T, A> interpolate_reversed(std::vector<T, A> f)
+    {
+        std::size_t const d = f.size() - 1;
+
+        // Divided differences: after step k, f[j] = Delta^k f(j - k) / k!.
+        for (std::size_t k = 1; k <= d; ++k)
+            for (std::size_t j = d; j >= k; --j)
+                f[j] = (f[j] - f[j - 1]) / T(static_cast<long int>(k));
+
+        // Expansion: c(t) <- c(t) * (t - k) + a_k.
+        std::vector<T, A> c(1, f[d]);
+        c.reserve(d + 1);
+        for (std::size_t k = d; k-- != 0; )
+        {
+            T const node = static_cast<long int>(k);
+            c.insert(c.begin(), T(0));
+            for (std::size_t i = 0; i + 1 < c.size(); ++i) { c[i] -= node * c[i + 1]; }
+            c[0] += f[k];
+        }
+
+        std::reverse(c.begin(), c.end());
+        return c;
+    }
+
+    template <typename T>
+    alexander_polynomial interpolate(scratch_vector<T> f)
+    {
+        scratch_vector<T> const c = interpolate_reversed(std::move(f));
+        return alexander_polynomial(c.begin(), c.end());
+    }
+
+    // Since t^d p(1/t) = (-1)^d p(t), the polynomial p is determined by about
+    // half of its coefficients, and hence by its values at about half as many
+    // points. For odd d, p(1) = 0 and r(t) = p(t) / (1 - t) is palindromic of
+    // even degree; for even d, r = p is. A palindromic polynomial r of degree
+    // 2m is r(t) = t^m g(t + 1/t), where g has degree m, so we interpolate g
+    // at the m + 1 nodes x = t + 1/t for t = 2, 3, ..., m + 2. These are
+    // distinct unless two of the points are reciprocal, which cannot happen
+    // modulo p if the square of the largest point is less than p.
+    bool symmetric_interpolation(std::size_t d, std::uint64_t p)
+    {
+        double const largest = d / 2 + 2;
+        return largest * largest < p;
+    }
+
+    std::size_t evaluation_count(std::size_t d, bool symmetric)
+    {
+        return symmetric ? d / 2 + 1 : d + 1;
+    }
+
+    long int evaluation_point(std::size_t j, bool symmetric)
+    {
+        return static_cast<long int>(symmetric ? j + 2 : j);
+    }
+
+    // Interpolates p(t) of degree at most d from its values at the points
+    // t = 2, 3, ..., d / 2 + 2 (see above), in the field T, and returns the
+    // coefficients of p starting at degree zero.
+    template <typename T>
+    std::vector<T> interpolate_symmetric(std::vector<T> y, std::size_t d)
+    {
+        std::size_t const m = d / 2;
+        bool const odd = d % 2 != 0;
+
+        // The values g(x) = r(t) / t^m.
+        std::vector<T> x;
+        x.reserve(m + 1);
+        for (std::size_t j = 0; j <= m; ++j)
+        {
+            T const t = evaluation_point(j, true);
+            x.push_back(t + T(1) / t);
+
+            T scale = odd ? T(1) - t : T(1);
+            for (std::size_t k = 0; k != m; ++k) { scale *= t; }
+            y[j] /= scale;
+        }
+
+        // Divided differences and expansion of the Newton form, as in
+        // interpolate_reversed(), but at arbitrary nodes.
+        for (std::size_t k = 1; k <= m; ++k)
+            for (std::size_t j = m; j >= k; --j)
+                y[j] = (y[j] - y[j - 1]) / (x[j] - x[j - k]);
+
+        std::vector<T> g(1, y[m]);
+        g.reserve(m + 1);
+        for (std::size_t k = m; k-- != 0; )
+        {
+            g.insert(g.begin(), T(0));
+            for (std::size_t i = 0; i + 1 < g.size(); ++i) { g[i] -= x[k] * g[i + 1]; }
+            g[0] += y[k];
+        }
+
+        // r(t) = sum_i g_i t^(m - i) (1 + t^2)^i.
+        std::vector<T> r(2 * m + 1, T(0)), power(1, T(1));
+        for (std::size_t i = 0; i <= m; ++i)
+        {
+            for (std::size_t k = 0; k != power.size(); ++k) { r[m - i + k] += g[i] * power[k]; }
+
+            power.resize(power.size() + 2, T(0));
+            for (std::size_t k = power.size() - 1; k >= 2; --k) { power[k] += power[k - 2]; }
+        }
+
+        if (odd)
+        {
+            r.push_back(T(0));
+            for (std::size_t i = r.size() - 1; i != 0; --i) { r[i] -= r[i - 1]; }
+        }
+        return r;
+    }
+
+    // Interpolates p modulo the current prime from its values at the points
+    // evaluation_point(j, symmetric), and returns its coefficients in reverse
+    // order as canonical representatives.
+    std::vector<std::uint64_t> interpolate_mod(std::vector<modular> values, std::size_t d, bool symmetric)
+    {
+        std::vector<modular> c;
+        if (symmetric)
+        {
+            c = interpolate_symmetric(std::move(values), d);
+            std::reverse(c.begin(), c.end());
+        }
+        else
+        {
+            c = interpolate_reversed(std::move(values));
+        }
+
+        std::vector<std::uint64_t> coeffs;
+        coeffs.reserve(c.size());
+        for (modular const & x : c) { coeffs.push_back(x.value()); }
+        return coeffs;
+    }
+
+    // Replaces the values f(w^0), f(w^1), ..., f(w^(N-1)) of a polynomial f of
+    // degree less than N at the powers of w = e^(2 pi i / N) by the
+    // coefficients of f, i.e. computes the inverse discrete Fourier transform.
+    // Requires that N = f.size() be a power of two.
+    void inverse_fft(scratch_vector<std::complex<double>> & f)
+    {
+        std::size_t const n = f.size();
+
+        // Bit-reversal permutation.
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n / 2;
+            for (; j & bit; bit /= 2) { j ^= bit; }
+            j ^= bit;
+            if (i < j) { std::swap(f[i], f[j]); }
+        }
+
+        // The twiddle factors w^-k, each computed directly for accuracy.
+        double const pi = std::acos(-1.0);
+        scratch_vector<std::complex<double>> twiddle;
+        twiddle.reserve(n / 2);
+        for (std::size_t k = 0; k != n / 2; ++k) { twiddle.push_back(std::polar(1.0, -2 * pi * k / n)); }
+
+        // Butterflies of length len use every (n / len)-th twiddle factor.
+        for (std::size_t len = 2; len <= n; len *= 2)
+        {
+            std::size_t const stride = n / len;
+            for (std::size_t i = 0; i != n; i += len)
+            {
+                for (std::size_t k = 0; k != len / 2; ++k)
+                {
+                    std::complex<double> const u = f[i + k];
+                    std::complex<double> const x = f[i + k + len / 2] * twiddle[k * stride];
+                    f[i + k] = u + x;
+                    f[i + k + len / 2] = u - x;
+                }
+            }
+        }
+
+        for (std::complex<double> & c : f) { c /= static_cast<double>(n); }
+    }
+
+    // Reconstructs the integers whose residues modulo the primes p_0, p_1,
+    // ..., p_{n-1} are residues[0][i], residues[1][i], etc., by Garner's
+    // algorithm: we find mixed-radix digits a_k such that
+    //
+    //    c = a_0 + a_1 p_0 + a_2 p_0 p_1 + ... + a_{n-1} p_0 ... p_{n-2}
+    //
+    // modulo the product of all the primes.
+    alexander_polynomial reconstruct(std::vector<std::uint64_t> const & primes,
+                                     std::vector<std::vector<std::uint64_t>> const & residues)
+    {
+        std::size_t const n = primes.size();
+
+        alexander_polynomial result;
+        result.reserve(residues[0].size());
+
+        std::vector<std::uint64_t> digits(n);
+        for (std::size_t i = 0; i != residues[0].size(); ++i)
+        {
+            for (std::size_t k = 0; k != n; ++k)
+            {
+                modular::field_guard guard(primes[k]);
+
+                modular x = modular(static_cast<long int>(residues[k][i]));
+                for (std::size_t j = 0; j != k; ++j)
+                {
+                    x = (x - modular(static_cast<long int>(digits[j])))
+                      / modular(static_cast<long int>(primes[j] % primes[k]));
+                }
+                digits[k] = x.value();
+            }
+
+            result.push_back(symmetric_value(digits, primes));
+        }
+
+        return result;
+    }
+}
+
+namespace
+{
+    // The number m of strands of a braid word, the number of its negative
+    // crossings, and the dimension d = n - m + 1 of the Seifert matrix of its
+    // closure, for n crossings. Requires that every strand occur.
+    struct braid_shape
+    {
+        std::size_t strands;
+        std::size_t negative;
+        std::size_t dim;
+    };
+
+    braid_shape shape_of_braid(pretzel_view braid)
+    {
+        braid_shape shape = { 1, 0, 0 };
+        for (twist const tw : braid)
+        {
+            CHECK(tw.second == 1 || tw.second == -1, "The Burau engine requires a braid word.");
+            shape.strands = std::max<std::size_t>(shape.strands, tw.first + 1);
+            if (tw.second < 0) { ++shape.negative; }
+        }
+
+        std::vector<bool> occurs(shape.strands, false);
+        for (twist const tw : braid) { occurs[tw.first] = true; }
+        CHECK(std::count(occurs.begin() + 1, occurs.end(), false) == 0, "The Burau engine requires a connected braid closure.");
+
+        shape.dim = braid.size() + 1 - shape.strands;
+        return shape;
+    }
+
+    // Replaces B by B R(s_i1^e1) R(s_i2^e2) ... for the braid word, where R is
+    // the reduced Burau representation evaluated at t (with inverse tinv).
+    // R(s_i) and R(s_i)^-1 differ from the identity only in row i - 1
+    // (counting from zero), which is
+    //
+    //    (..., t, -t, 1, ...)  and  (..., 1, -1/t, 1/t, ...)
+    //
+    // in columns i - 2, i - 1 and i, truncated to the (m - 1) x (m - 1) matrix.
+    // So each crossing is an operation on three columns of B.
+    template <typename T>
+    void multiply_burau(pretzel_view braid, T const & t, T const & tinv, square_matrix<T> & b)
+    {
+        std::size_t const n = b.dim();
+        for (twist const tw : braid)
+        {
+            std::size_t const j = tw.first - 1;
+            bool const positive = tw.second > 0;
+
+            for (std::size_t r = 0; r != n; ++r)
+            {
+                T const x = b(r, j);
+                if (j != 0)     { b(r, j - 1) += positive ? t * x : x; }
+                if (j + 1 != n) { b(r, j + 1) += positive ? x : tinv * x; }
+                b(r, j) = positive ? -(t * x) : -(tinv * x);
+            }
+        }
+    }
+
+    // Returns an upper bound for log2 of the sum of the absolute values of the
+    // coefficients of p(t), via the sums of the absolute values of the
+    // coefficients of the entries of the Burau matrix B: each crossing adds a
+    // column to its neighbours, and the coefficients of det(I - B) are bounded
+    // by the product of the row sums of I + |B|. Dividing by (1 - t^m) / (1 - t)
+    // multiplies the bound by at most 2 (d / m + 1).
+    double burau_coefficient_bits(pretzel_view braid, braid_shape const & shape)
+    {
+        std::size_t const n = shape.strands - 1;
+
+        // The sums, scaled by 2^-scale to avoid overflow.
+        square_matrix<double> b(n);
+        for (std::size_t i = 0; i != n; ++i) { b(i, i) = 1; }
+        double scale = 0;
+
+        for (twist const tw : braid)
+        {
+            std::size_t const j = tw.first - 1;
+            double largest = 0;
+            for (std::size_t r = 0; r != n; ++r)
+            {
+                if (j != 0)     { b(r, j - 1) += b(r, j); largest = std::max(largest, b(r, j - 1)); }
+                if (j + 1 != n) { b(r, j + 1) += b(r, j); largest = std::max(largest, b(r, j + 1)); }
+            }
+
+            if (largest > std::ldexp(1.0, 512))
+            {
+                for (std::size_t r = 0; r != n; ++r)
+                    for (std::size_t c = 0; c != n; ++c) { b(r, c) = std::ldexp(b(r, c), -512); }
+                scale += 512;
+            }
+        }
+
+        double bits = std::log2(2 * (shape.dim / double(shape.strands) + 1));
+        for (std::size_t r = 0; r != n; ++r)
+        {
+            double row_sum = std::ldexp(1.0, -static_cast<int>(scale));
+            for (std::size_t c = 0; c != n; ++c) { row_sum += b(r, c); }
+            bits += std::log2(row_sum) + scale;
+        }
+        return bits;
+    }
+}
+
+bool parse_alexander_engine(std::string const & name, alexander_engine * out)
+{
+    if      (name == "vandermonde") { *out = alexander_engine::vandermonde; return true; }
+    else if (name == "exact")       { *out = alexander_engine::exact;       return true; }
+    else if (name == "modular")     { *out = alexander_engine::modular;     return true; }
+    else if (name == "hessenberg")  { *out = alexander_engine::hessenberg;  return true; }
+    else if (name == "fft")         { *out = alexander_engine::fft;         return true; }
+    else if (name == "sparse")      { *out = alexander_engine::sparse;      return true; }
+    else if (name == "burau")       { *out = alexander_engine::burau;       return true; }
+    else                            { return false;                                      }
+}
+
+integer_width exact_width(square_matrix<int> const & sm)
+// The entries of M - t M* for 0 <= t <= d are bounded by |m_ij| + d |m_ji|.
+// By Hadamard's inequality, every minor of such a matrix is bounded by H, the
+// product of the Euclidean norms of its rows (or 1, if a norm is less than 1).
+//
+// The Bareiss elimination produces minors and products of two minors, i.e.
+// values of at most 2 H^2. The interpolation produces differences of the
+// values of up to 2^d H, and the expansion of the Newton form produces values
+// of up to d 2^(d + 1) H.
+{
+    double const d = sm.dim();
+
+    double h = 0;    // log2(H)
+    for (std::size_t i = 0; i != sm.dim(); ++i)
+    {
+        double norm2 = 0;
+        for (std::size_t j = 0; j != sm.dim(); ++j)
+        {
+            double e = std::abs(static_cast<double>(sm(i, j))) + d * std::abs(static_cast<double>(sm(j, i)));
+            norm2 += e * e;
+        }
+        if (norm2 > 1) { h += std::log2(norm2) / 2; }
+    }
+
+    double const bits = std::max(2 * h + 1, h + d + 1 + std::log2(d + 1));
+
+    if (bits < 62)  { return integer_width::int64;  }
+    if (bits < 126) { return integer_width::int128; }
+    return integer_width::big;
+}
+
+alexander_polynomial alexander_poly(square_matrix<int> const & sm, alexander_engine engine)
+{
+    switch (engine)
+    {
+        case alexander_engine::vandermonde: return alexander_poly_vandermonde(sm);
+        case alexander_engine::exact:       return alexander_poly_exact(sm);
+        case alexander_engine::modular:     return alexander_poly_modular(sm);
+        case alexander_engine::hessenberg:  return alexander_poly_hessenberg(sm);
+        case alexander_engine::fft:         return alexander_poly_fft(sm);
+        case alexander_engine::sparse:
+        case alexander_engine::burau:       return alexander_poly_sparse(sparse_matrix<int>(sm));
+    }
+
+    CHECK(false, "Unknown Alexander polynomial engine");
+    return alexander_polynomial();
+}
+
+alexander_polynomial alexander_poly(sparse_matrix<int> const & sm, alexander_engine engine)
+{
+    if (engine == alexander_engine::sparse || engine == alexander_engine::burau) { return alexander_poly_sparse(sm); }
+
+    return alexander_poly(square_matrix<int>(sm.to_dense()), engine);
+}
+
+alexander_polynomial alexander_poly_vandermonde(square_matrix<int> const & sm)
+// We compute the coefficients of the Alexander polynomial by evaluating it on
+// d + 1 points, where d == sm.dim() is its degree. Solving for the coefficients
+// amounts to solving a Vandermonde system with the values at those points.
+// The Vandermonde matrix depends only on d, so we factorize it once per
+// dimension, and each solution then takes O(d^2) operations (with the same
+// result as Gauss-Jordan elimination of the augmented matrix).
+//
+// The values at the points are determinants of integer matrices, which we
+// compute exactly by fraction-free elimination in a sufficiently wide integer
+// type. However, the Vandermonde system has to be solved with floating point
+// numbers, and we round the result back to the nearest integer.
+{
+    // Step 1: Fill in the result p(t) = det(M - t M*) at the points 0, 1, ..., d.
+    scratch_vector<double> values;
+    switch (exact_width(sm))
+    {
+        case integer_width::int64:  values = evaluate_as_double<long int>(sm); break;
+        case integer_width::int128: values = evaluate_as_double<int128>(sm);   break;
+        case integer_width::big:    values = evaluate_as_double<bigint>(sm);   break;
+    }
+
+    // Step 2: Solve the Vandermonde system with the cached factorization.
+    vandermonde_factorization(sm.dim())->solve_in_place(values);
+
+    // Step 3: Obtain the resulting polynomial coefficients by rounding.
+    alexander_polynomial coeffs;
+    coeffs.reserve(sm.dim() + 1);
+    for (std::size_t i = 0; i != sm.dim() + 1; ++i)
+    {
+        std::size_t const ri = sm.dim() - i;
+        coeffs.push_back(std::lround(values[ri]));
+    }
+
+    // Step 4: Profit.
+    return coeffs;
+}
+
+alexander_polynomial alexander_poly_fft(square_matrix<int> const & sm)
+// We evaluate p(t) = det(M - t M*) at the powers of w = e^(2 pi i / N) by
+// Gauss elimination in complex floating point. Since p has real coefficients,
+// p(w^(N - k)) is the complex conjugate of p(w^k), so only half of the values
+// require a determinant. The inverse Fourier transform of the values yields
+// the coefficients, which we round to the nearest integer.
+//
+// The rounding errors of the determinants grow with d and with the size of
+// the values, and for dimensions in the hundreds they can exceed 1/2 even if
+// the coefficients fit into a double. So we check the rounded coefficients
+// modulo one large prime against alexander_poly_hessenberg_mod(), which takes
+// O(d^3) operations like the evaluation itself. (A wrong result that passes
+// this check would have to be off by a multiple of a prime of about 2^62 in
+// every wrong coefficient.) If the check fails, or a coefficient does not fit
+// into a double, we fall back to the exact sparse engine.
+//
+// The work for each point is released before the next one, so it does not
+// belong in an arena.
+{
+    arena::suspend heap;
+
+    using complex = std::complex<double>;
+
+    std::size_t const d = sm.dim();
+    std::size_t n = 1;
+    while (n <= d) { n *= 2; }
+
+    square_matrix<complex> const am(sm);
+    scratch_vector<complex> values(n);
+
+    double const pi = std::acos(-1.0);
+    parallel_for(n / 2 + 1, [&](std::size_t first, std::size_t last)
+    {
+        square_matrix<complex> work(d);
+        for (std::size_t k = first; k != last; ++k)
+        {
+            complex const t = std::polar(1.0, 2 * pi * k / n);
+            work.assign(am + am.transposed() * -t);
+            values[k] = work.determinant_in_place();
+            if (k != 0) { values[n - k] = std::conj(values[k]); }
+        }
+    });
+
+    inverse_fft(values);
+
+    std::uint64_t const p = large_primes(1).front();
+    std::vector<std::uint64_t> const residues = alexander_poly_hessenberg_mod(sm, p);
+
+    alexander_polynomial coeffs;
+    coeffs.reserve(d + 1);
+    for (std::size_t i = 0; i != d + 1; ++i)
+    {
+        double const c = values[d - i].real();
+        if (!(std::abs(c) < std::ldexp(1.0, 52))) { return alexander_poly_sparse(sparse_matrix<int>(sm)); }
+
+        long int const rounded = std::lround(c);
+        std::uint64_t const residue = rounded < 0 ? p - static_cast<std::uint64_t>(-rounded) % p
+                                                  : static_cast<std::uint64_t>(rounded) % p;
+        if (residue % p != residues[i]) { return alexander_poly_sparse(sparse_matrix<int>(sm)); }
+
+        coeffs.push_back(rounded);
+    }
+    return coeffs;
+}
+
+alexander_polynomial alexander_poly_exact(square_matrix<int> const & sm)
+// The same evaluation as in alexander_poly_vandermonde(), but followed by
+// exact interpolation, all in the narrowest sufficient integer type.
+{
+    switch (exact_width(sm))
+    {
+        case integer_width::int64:  return interpolate(evaluate<long int>(sm));
+        case integer_width::int128: return interpolate(evaluate<int128>(sm));
+        case integer_width::big:    return interpolate(evaluate<bigint>(sm));
+    }
+
+    CHECK(false, "Unknown integer width");
+    return alexander_polynomial();
+}
+
+std::vector<std::uint64_t> alexander_poly_mod(square_matrix<int> const & sm, std::uint64_t p)
+// This is the same computation as in alexander_poly_exact(), but all
+// arithmetic is exact in GF(p). Unless p is small, the symmetry of p(t)
+// halves the number of evaluations (see symmetric_interpolation()); the
+// value p(0) = det(M), which is then not among them, serves as a check.
+{
+    CHECK(sm.dim() < p, "The prime must exceed the number of evaluation points.");
+
+    modular::field_guard guard(p);
+
+    std::size_t const d = sm.dim();
+    bool const symmetric = symmetric_interpolation(d, p);
+
+    square_matrix<modular> const am(sm);
+    std::vector<modular> values(evaluation_count(d, symmetric));
+    parallel_for(values.size(), [&](std::size_t first, std::size_t last)
+    {
+        modular::field_guard task_guard(p);
+        square_matrix<modular> work(d);
+        for (std::size_t i = first; i != last; ++i)
+        {
+            work.assign(am + am.transposed() * -modular(evaluation_point(i, symmetric)));
+            values[i] = work.determinant_in_place();
+        }
+    });
+
+    std::vector<std::uint64_t> const coeffs = interpolate_mod(std::move(values), d, symmetric);
+    CHECK(!symmetric || coeffs[d] == am.determinant().value(), "The Alexander polynomial is not symmetric.");
+    return coeffs;
+}
+
+alexander_polynomial alexander_poly_modular(square_matrix<int> const & sm)
+// We compute the coefficients modulo enough primes that their product exceeds
+// twice the coefficient bound, and then reconstruct them by the Chinese
+// remainder theorem. The primes are independent of one another until the
+// final reconstruction.
+//
+// The work for each prime is released before the next one, so it does not
+// belong in an arena.
+{
+    arena::suspend heap;
+
+    std::vector<std::uint64_t> const primes = primes_for(coefficient_bits(sm));
+
+    std::vector<std::vector<std::uint64_t>> residues;
+    residues.reserve(primes.size());
+    for (std::uint64_t p : primes) { residues.push_back(alexander_poly_mod(sm, p)); }
+
+    return reconstruct(primes, residues);
+}
+
+std::vector<std::uint64_t> alexander_poly_hessenberg_mod(square_matrix<int> const & sm, std::uint64_t p)
+// We choose a point c for which N = M - c M* is invertible. Then
+//
+//    p(t) = det(N - (t - c) M*) = det(N) det(I - (t - c) B),  where B = N^-1 M*,
+//
+// and det(I - u B) = u^d chi(1/u) is the reversal of the characteristic
+// polynomial chi of B. Substituting u = t - c yields p. If there is no such
+// point among 0, 1, ..., d, then p has d + 1 roots, so it is zero.
+{
+    CHECK(sm.dim() < p, "The prime must exceed the number of evaluation points.");
+
+    modular::field_guard guard(p);
+
+    std::size_t const d = sm.dim();
+    square_matrix<modular> const am(sm);
+    square_matrix<modular> n(d);
+
+    for (std::size_t c = 0; c <= d; ++c)
+    {
+        modular const point = static_cast<long int>(c);
+        n.assign(am + am.transposed() * -point);
+        modular const det = n.determinant();
+        if (det == 0) { continue; }
+
+        // B = N^-1 M*, by Gauss-Jordan elimination of (N | M*).
+        matrix<modular> augmented(d, 2 * d);
+        for (std::size_t i = 0; i != d; ++i)
+        {
+            for (std::size_t j = 0; j != d; ++j)
+            {
+                augmented(i, j) = n(i, j);
+                augmented(i, d + j) = am(j, i);
+            }
+        }
+        matrix<modular> const reduced = augmented.gauss_jordan();
+
+        square_matrix<modular> b(d);
+        for (std::size_t i = 0; i != d; ++i)
+            for (std::size_t j = 0; j != d; ++j)
+                b(i, j) = reduced(i, d + j);
+
+        scratch_vector<modular> const chi = b.characteristic_polynomial();
+
+        // Horner's scheme in t for q(t - c), where q(u) = sum_k chi[k] u^(d - k).
+        scratch_vector<modular> q(1, chi[0]);
+        q.reserve(d + 1);
+        for (std::size_t k = 1; k <= d; ++k)
+        {
+            q.push_back(0);
+            for (std::size_t i = q.size() - 1; i != 0; --i) { q[i] = q[i - 1] - point * q[i]; }
+            q[0] = chi[k] - point * q[0];
+        }
+
+        // q has the coefficients of p / det(N), starting at degree zero; the
+        // result is in reverse order.
+        std::vector<std::uint64_t> coeffs;
+        coeffs.reserve(d + 1);
+        for (std::size_t i = 0; i != d + 1; ++i) { coeffs.push_back((det * q[d - i]).value()); }
+        return coeffs;
+    }
+
+    return std::vector<std::uint64_t>(d + 1, 0);
+}
+
+alexander_polynomial alexander_poly_hessenberg(square_matrix<int> const & sm)
+// The same reconstruction as in alexander_poly_modular(), from the residues
+// computed via characteristic polynomials.
+{
+    arena::suspend heap;
+
+    std::vector<std::uint64_t> const primes = primes_for(coefficient_bits(sm));
+
+    // There are no evaluation points, so the primes are computed in parallel.
+    std::vector<std::vector<std::uint64_t>> residues(primes.size());
+    parallel_for(primes.size(), [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t k = first; k != last; ++k) { residues[k] = alexander_poly_hessenberg_mod(sm, primes[k]); }
+    });
+
+    return reconstruct(primes, residues);
+}
+
+std::vector<std::uint64_t> alexander_poly_mod(sparse_matrix<int> const & sm, std::uint64_t p)
+// As above, but the values are determinants of sparse matrices.
+{
+    CHECK(sm.rows() < p, "The prime must exceed the number of evaluation points.");
+
+    modular::field_guard guard(p);
+
+    std::size_t const d = sm.rows();
+    bool const symmetric = symmetric_interpolation(d, p);
+
+    sparse_matrix<modular> const am(sm);
+    sparse_matrix<modular> const amt = am.transpose();
+
+    std::vector<modular> values(evaluation_count(d, symmetric));
+    parallel_for(values.size(), [&](std::size_t first, std::size_t last)
+    {
+        modular::field_guard task_guard(p);
+        for (std::size_t i = first; i != last; ++i)
+        {
+            values[i] = (am + amt * -modular(evaluation_point(i, symmetric))).determinant();
+        }
+    });
+
+    std::vector<std::uint64_t> const coeffs = interpolate_mod(std::move(values), d, symmetric);
+    CHECK(!symmetric || coeffs[d] == am.determinant().value(), "The Alexander polynomial is not symmetric.");
+    return coeffs;
+}
+
+alexander_polynomial alexander_poly_sparse(sparse_matrix<int> const & sm)
+// The same reconstruction as in alexander_poly_modular(), from the residues
+// computed by sparse elimination.
+{
+    CHECK(sm.rows() == sm.cols(), "Trying to use a non-square Seifert matrix!");
+
+    arena::suspend heap;
+
+    std::vector<std::uint64_t> const primes = primes_for(coefficient_bits(sm));
+
+    std::vector<std::vector<std::uint64_t>> residues;
+    residues.reserve(primes.size());
+    for (std::uint64_t p : primes) { residues.push_back(alexander_poly_mod(sm, p)); }
+
+    return reconstruct(primes, residues);
+}
+
+std::vector<std::uint64_t> alexander_poly_burau_mod(pretzel_view braid, std::uint64_t p)
+// With the reduced Burau matrix B of a braid on m strands with n crossings, of
+// which n_- are negative, the Alexander polynomial of its closure is
+//
+//    det(M - t M*) = (-1)^d t^(n_-) (1 - t) / (1 - t^m) det(I - B(t)),
+//
+// where M is the Seifert matrix, of dimension d = n - m + 1. We evaluate this
+// at the same points as alexander_poly_mod(), each in O(n m + m^3) operations,
+// and interpolate.
+{
+    CHECK(burau_prime_suitable(braid, p), "The prime is unsuitable for the Burau engine.");
+
+    braid_shape const shape = shape_of_braid(braid);
+    std::size_t const d = shape.dim;
+
+    modular::field_guard guard(p);
+
+    std::vector<modular> values(evaluation_count(d, true));
+    parallel_for(values.size(), [&](std::size_t first, std::size_t last)
+    {
+        modular::field_guard task_guard(p);
+        square_matrix<modular> b(shape.strands - 1);
+        for (std::size_t i = first; i != last; ++i)
+        {
+            modular const t = evaluation_point(i, true);
+
+            for (std::size_t r = 0; r != b.dim(); ++r)
+                for (std::size_t c = 0; c != b.dim(); ++c) { b(r, c) = r == c ? 1 : 0; }
+            multiply_burau(braid, t, modular(1) / t, b);
+
+            // B becomes I - B.
+            for (std::size_t r = 0; r != b.dim(); ++r)
+            {
+                for (std::size_t c = 0; c != b.dim(); ++c) { b(r, c) = -b(r, c); }
+                b(r, r) += 1;
+            }
+
+            modular scale = d % 2 ? -1 : 1, power = 1;
+            for (std::size_t k = 0; k != shape.negative; ++k) { scale *= t; }
+            for (std::size_t k = 0; k != shape.strands; ++k) { power *= t; }
+
+            values[i] = scale * (modular(1) - t) / (modular(1) - power) * b.determinant_in_place();
+        }
+    });
+
+    return interpolate_mod(std::move(values), d, true);
+}
+
+bool burau_prime_suitable(pretzel_view braid, std::uint64_t p)
+{
+    braid_shape const shape = shape_of_braid(braid);
+    std::size_t const d = shape.dim;
+
+    if (d >= p || !symmetric_interpolation(d, p)) { return false; }
+
+    modular::field_guard guard(p);
+    for (std::size_t i = 0; i != evaluation_count(d, true); ++i)
+    {
+        modular const t = evaluation_point(i, true);
+        modular power = 1;
+        for (std::size_t k = 0; k != shape.strands; ++k) { power *= t; }
+        if (power == 1) { return false; }
+    }
+    return true;
+}
+
+alexander_polynomial alexander_poly_burau(pretzel_view braid)
+// The same reconstruction as in alexander_poly_modular(), from the residues
+// computed via the Burau representation, except that we skip the (very rare)
+// primes modulo which an evaluation point is an m-th root of unity.
+{
+    arena::suspend heap;
+
+    std::size_t const count = primes_for(burau_coefficient_bits(braid, shape_of_braid(braid))).size();
+
+    std::vector<std::uint64_t> primes, candidates = large_primes(count);
+    for (std::size_t next = 0; primes.size() != count; ++next)
+    {
+        if (next == candidates.size()) { candidates = large_primes(2 * candidates.size()); }
+        if (burau_prime_suitable(braid, candidates[next])) { primes.push_back(candidates[next]); }
+    }
+
+    std::vector<std::vector<std::uint64_t>> residues;
+    residues.reserve(primes.size());
+    for (std::uint64_t p : primes) { residues.push_back(alexander_poly_burau_mod(braid, p)); }
+
+    return reconstruct(primes, residues);
+}
@@ -0,0 +1,141 @@
+// Computation of the Alexander polynomial of a link from its Seifert matrix.
+//
+// The Alexander polynomial of a link with Seifert matrix M is (up to units)
+// p(t) = det(M - t M*), where M* is the transpose of M. If M has dimension d,
+// then p has degree at most d, and t^d p(1/t) = det(t M - M*) = (-1)^d p(t).
+// All engines return the coefficients of det(t M - M*), i.e. those of p in
+// reverse order, starting at degree zero. Several engines are available:
+//
+//    - vandermonde: Evaluates p at the points 0, 1, ..., d exactly and solves
+//      the Vandermonde system in floating point. Fast for small matrices, but
+//      the Vandermonde system becomes ill-conditioned beyond about d = 20.
+//
+//    - exact: Evaluates p at the same points, but interpolates exactly. All
+//      arithmetic is performed in the narrowest integer type (64 bit, 128 bit
+//      or arbitrary precision) that a bound on the intermediate values
+//      permits, so that small inputs are fast and large ones are correct.
+//
+//    - modular: Evaluates and interpolates p over several prime fields GF(p)
+//      and reconstructs the integer coefficients by the Chinese remainder
+//      theorem. Exact for any dimension. Thanks to the symmetry of p, only
+//      about d / 2 + 1 evaluations are needed per prime.
+//
+//    - hessenberg: Like modular, but computes p modulo each prime in one pass,
+//      as the characteristic polynomial of a d x d matrix (via Hessenberg
+//      form), in O(d^3) rather than O(d^4) operations.
+//
+//    - fft: Evaluates p in complex floating point at the N-th roots of unity,
+//      where N is the least power of two greater than d, and recovers the
+//      coefficients by an inverse fast Fourier transform. Evaluation on the
+//      unit circle is well-conditioned (the discrete Fourier transform is
+//      unitary), but the rounding errors of the determinants still grow with
+//      the dimension, and beyond about d = 200 they can spoil the result even
+//      if the coefficients fit into a double. So the result is checked modulo
+//      a prime, and if it is wrong (or a coefficient is too large), the
+//      sparse engine computes it instead.
+//
+//    - sparse: Like modular, but keeps the Seifert matrix sparse and evaluates
+//      p by sparse LU decomposition, which limits fill-in. Seifert matrices
+//      have only a few non-zero entries per row, so this is the engine of
+//      choice for braids with thousands of crossings.
+//
+//    - burau: Like modular, but starts from the braid word rather than from
+//      the Seifert matrix: with the reduced Burau matrix B(t) of a braid on m
+//      strands, p is t^k (1 - t) / (1 - t^m) det(I - B(t)) up to sign, which
+//      costs O(n m + m^3) per evaluation for n crossings instead of a
+//      determinant of dimension n - m + 1. So it is the fastest engine for
+//      long braids on few strands. Given only a Seifert matrix, alexander_poly()
+//      falls back to the sparse engine.
+
+#ifndef H_ALEXANDER
+#define H_ALEXANDER
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arena.hpp"
+#include "bigint.hpp"
+#include "matrix.hpp"
+#include "pretzel.hpp"
+#include "sparse_matrix.hpp"
+
+// The coefficients of an Alexander polynomial. Like matrices and pretzels,
+// they take their memory from the current arena, if any (see arena.hpp).
+using alexander_polynomial = scratch_vector<bigint>;
+
+enum class alexander_engine
+{
+    vandermonde,
+    exact,
+    modular,
+    hessenberg,
+    fft,
+    sparse,
+    burau,
+};
+
+// Parses an engine name ("vandermonde", "exact", "modular", "hessenberg", "fft",
+// "sparse", "burau"). If parsing succeeds, returns true and stores the engine in *out;
+// otherwise returns false and *out is not modified.
+bool parse_alexander_engine(std::string const & name, alexander_engine * out);
+
+// Compute an Alexander polynomial from a Seifert matrix with the given engine.
+// Returns the list of coefficients of det(t M - M*), starting at degree zero.
+alexander_polynomial alexander_poly(square_matrix<int> const & sm,
+                                    alexander_engine engine = alexander_engine::vandermonde);
+
+// The same for a sparse Seifert matrix; only the sparse engine avoids
+// converting it to a dense matrix.
+alexander_polynomial alexander_poly(sparse_matrix<int> const & sm,
+                                    alexander_engine engine = alexander_engine::vandermonde);
+
+alexander_polynomial alexander_poly_vandermonde(square_matrix<int> const & sm);
+alexander_polynomial alexander_poly_exact(square_matrix<int> const & sm);
+alexander_polynomial alexander_poly_modular(square_matrix<int> const & sm);
+alexander_polynomial alexander_poly_hessenberg(square_matrix<int> const & sm);
+alexander_polynomial alexander_poly_fft(square_matrix<int> const & sm);
+alexander_polynomial alexander_poly_sparse(sparse_matrix<int> const & sm);
+
+// Computes the Alexander polynomial of the closure of a braid word, i.e. of a
+// pretzel all of whose twists are (i, +1) or (i, -1), via the Burau
+// representation. The result is the same as that of the other engines for the
+// Seifert matrix compute_seifert_matrix(braid). Requires that every strand be
+// part of some twist, so that the closure is connected.
+alexander_polynomial alexander_poly_burau(pretzel_view braid);
+
+// The integer types in which the exact evaluation and interpolation of the
+// Alexander polynomial can be performed.
+enum class integer_width
+{
+    int64,      // long int
+    int128,     // __int128
+    big,        // bigint
+};
+
+// Returns the narrowest integer width in which the determinants det(M - t M*)
+// at t = 0, 1, ..., d and their interpolation can be computed without overflow,
+// based on Hadamard's bound for the entries of the Seifert matrix.
+integer_width exact_width(square_matrix<int> const & sm);
+
+// Computes the coefficients of det(t M - M*) modulo the prime p, as canonical
+// representatives in [0, p). Requires that p be an odd prime less than 2^62
+// and greater than the dimension of M. For primes greater than about d^2 / 4,
+// the symmetry of p halves the number of evaluations.
+std::vector<std::uint64_t> alexander_poly_mod(square_matrix<int> const & sm, std::uint64_t p);
+std::vector<std::uint64_t> alexander_poly_mod(sparse_matrix<int> const & sm, std::uint64_t p);
+
+// The same, computed via the characteristic polynomial (see above).
+std::vector<std::uint64_t> alexander_poly_hessenberg_mod(square_matrix<int> const & sm, std::uint64_t p);
+
+// The same for the closure of a braid word on m strands, via the Burau
+// representation (see above). Requires burau_prime_suitable(braid, p).
+std::vector<std::uint64_t> alexander_poly_burau_mod(pretzel_view braid, std::uint64_t p);
+
+// Returns whether alexander_poly_burau_mod() can use the prime p: p must be
+// greater than about n^2 / 4 for n crossings, and none of the evaluation
+// points may be an m-th root of unity modulo p, since the evaluation divides
+// by 1 - t^m. The latter rules out only a handful of primes.
+bool burau_prime_suitable(pretzel_view braid, std::uint64_t p);
+
+#endif
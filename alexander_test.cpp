@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "alexander.hpp"
+#include "algorithms.hpp"
+#include "modular.hpp"
+#include "parallel.hpp"
+#include "pretzel.hpp"   // for printing vectors
+#include "testing.hpp"
+
+namespace
+{
+    square_matrix<int> make_matrix(std::initializer_list<std::initializer_list<int>> rows)
+    {
+        square_matrix<int> m(rows.size());
+        std::size_t i = 0;
+        for (auto const & row : rows)
+        {
+            std::size_t j = 0;
+            for (int x : row) { m(i, j++) = x; }
+            ++i;
+        }
+        return m;
+    }
+
+    // The identity matrix of dimension d has p(t) = (1 - t)^d.
+    alexander_polynomial one_minus_t_to_the(std::size_t d)
+    {
+        alexander_polynomial coeffs(1, 1);
+        for (std::size_t k = 0; k != d; ++k)
+        {
+            coeffs.push_back(0);
+            for (std::size_t i = coeffs.size() - 1; i != 0; --i) { coeffs[i] -= coeffs[i - 1]; }
+        }
+        return coeffs;
+    }
+
+    // A banded matrix like those from Seifert surfaces.
+    square_matrix<int> banded(std::size_t d)
+    {
+        square_matrix<int> m(d);
+        for (std::size_t i = 0; i != d; ++i)
+        {
+            m(i, i) = int(i % 3) - 1;
+            if (i + 1 != d) { m(i, i + 1) = 1; m(i + 1, i) = int(i % 2); }
+            if (i + 5 < d)  { m(i + 5, i) = -1; }
+        }
+        return m;
+    }
+
+    alexander_engine const all_engines[] = {
+        alexander_engine::vandermonde, alexander_engine::exact, alexander_engine::modular,
+        alexander_engine::hessenberg, alexander_engine::fft, alexander_engine::sparse,
+        alexander_engine::burau };
+
+    alexander_polynomial burau_of(std::string const & s)
+    {
+        pretzel pr;
+        parse_string_as_pretzel(s, &pr);
+        return alexander_poly_burau(pr);
+    }
+}
+
+void TestParseEngine()
+{
+    alexander_engine engine = alexander_engine::vandermonde;
+    EXPECT_TRUE(parse_alexander_engine("modular", &engine));
+    EXPECT_TRUE(engine == alexander_engine::modular);
+    EXPECT_TRUE(parse_alexander_engine("hessenberg", &engine));
+    EXPECT_TRUE(engine == alexander_engine::hessenberg);
+    EXPECT_TRUE(parse_alexander_engine("fft", &engine));
+    EXPECT_TRUE(engine == alexander_engine::fft);
+    EXPECT_TRUE(parse_alexander_engine("sparse", &engine));
+    EXPECT_TRUE(engine == alexander_engine::sparse);
+    EXPECT_TRUE(parse_alexander_engine("burau", &engine));
+    EXPECT_TRUE(engine == alexander_engine::burau);
+    EXPECT_TRUE(parse_alexander_engine("exact", &engine));
+    EXPECT_TRUE(engine == alexander_engine::exact);
+    EXPECT_TRUE(parse_alexander_engine("vandermonde", &engine));
+    EXPECT_TRUE(engine == alexander_engine::vandermonde);
+    EXPECT_FALSE(parse_alexander_engine("bogus", &engine));
+    EXPECT_TRUE(engine == alexander_engine::vandermonde);
+}
+
+void TestSmallKnots()
+{
+    for (alexander_engine engine : all_engines)
+    {
+        // Figure eight knot "AbAb".
+        alexander_polynomial figure_eight = { -1, 3, -1 };
+        EXPECT_EQ(alexander_poly(make_matrix({{-1, 1}, {0, 1}}), engine), figure_eight);
+
+        // Trefoil "AAA".
+        alexander_polynomial trefoil = { 1, -1, 1 };
+        EXPECT_EQ(alexander_poly(make_matrix({{-1, 0}, {1, -1}}), engine), trefoil);
+
+        // Pretzel "A3B5C7".
+        alexander_polynomial pretzel = { -35, 71, -35 };
+        EXPECT_EQ(alexander_poly(make_matrix({{-5, 1}, {0, 7}}), engine), pretzel);
+
+        // Odd dimension, where the coefficients of det(t M - M*) differ from
+        // those of det(M - t M*) by sign: "AbCdAbCd".
+        alexander_polynomial link = { 0, -1, 2, -2, 1, 0 };
+        EXPECT_EQ(alexander_poly(make_matrix({{-1, 0, 0, 0, 0}, {0, 0, 1, 0, 0}, {0, 0, 1, 1, 0},
+                                              {0, 0, 0, 1, 0}, {1, 0, 0, 0, -1}}), engine), link);
+
+        // Empty Seifert matrix (the unknot).
+        EXPECT_EQ(alexander_poly(square_matrix<int>(0), engine), alexander_polynomial(1, 1));
+
+        // Zero row.
+        alexander_polynomial zero(3, 0);
+        EXPECT_EQ(alexander_poly(make_matrix({{0, 0}, {0, 1}}), engine), zero);
+    }
+}
+
+void TestLargeDimension()
+{
+    // The Vandermonde system for 41 points is far too ill-conditioned for
+    // floating point, but the exact and modular engines are exact, and the
+    // Fourier transform is well-conditioned.
+    square_matrix<int> id(40);
+    for (std::size_t i = 0; i != id.dim(); ++i) { id(i, i) = 1; }
+    EXPECT_EQ(alexander_poly(id, alexander_engine::exact), one_minus_t_to_the(40));
+    EXPECT_EQ(alexander_poly(id, alexander_engine::modular), one_minus_t_to_the(40));
+    EXPECT_EQ(alexander_poly(id, alexander_engine::sparse), one_minus_t_to_the(40));
+    EXPECT_EQ(alexander_poly(id, alexander_engine::hessenberg), one_minus_t_to_the(40));
+    EXPECT_EQ(alexander_poly(id, alexander_engine::fft), one_minus_t_to_the(40));
+}
+
+void TestFFT()
+{
+    // The torus knot T(2, 151) (the braid "A" repeated 151 times) has a
+    // Seifert matrix of dimension 150 (so that 256 points are used) and
+    // p(t) = 1 - t + t^2 - ... + t^150.
+    std::size_t const d = 150;
+    square_matrix<int> m(d);
+    for (std::size_t i = 0; i != d; ++i)
+    {
+        m(i, i) = -1;
+        if (i + 1 != d) { m(i + 1, i) = 1; }
+    }
+
+    alexander_polynomial expected;
+    for (std::size_t i = 0; i != d + 1; ++i) { expected.push_back(i % 2 == 0 ? 1 : -1); }
+    EXPECT_EQ(alexander_poly(m, alexander_engine::fft), expected);
+
+    // A random braid on 5 strands with a Seifert matrix of dimension 249. Its
+    // coefficients (up to about 2.6e14) fit into a double, but the rounding
+    // errors do not stay below 1/2, so the result must come from the fallback.
+    std::mt19937 rng(5);
+    pretzel pr;
+    for (int i = 0; i != 253; ++i)
+    {
+        unsigned int const generator = rng() % 4 + 1;
+        pr.emplace_back(generator, rng() % 2 ? 1 : -1);
+    }
+    EXPECT_EQ(alexander_poly(compute_seifert_matrix(pr), alexander_engine::fft), alexander_poly_burau(pr));
+
+    // (1000 t - 1000)^8 has coefficients beyond the precision of a double.
+    square_matrix<int> large(8);
+    for (std::size_t i = 0; i != large.dim(); ++i) { large(i, i) = 1000; }
+    EXPECT_EQ(alexander_poly(large, alexander_engine::fft), alexander_poly(large, alexander_engine::exact));
+}
+
+void TestHessenberg()
+{
+    // M is singular, and so is M - M* (since it is skew-symmetric of odd
+    // dimension), so that N = M - c M* is first invertible at c = 2.
+    square_matrix<int> m(3);
+    m(0, 0) = 1; m(0, 1) = 1;
+    m(1, 0) = 1; m(1, 1) = 1;
+    m(2, 1) = 1; m(2, 2) = 1;
+    EXPECT_EQ(alexander_poly(m, alexander_engine::hessenberg), alexander_poly(m, alexander_engine::exact));
+
+    // A larger banded matrix with sizeable coefficients.
+    square_matrix<int> band = banded(60);
+    EXPECT_EQ(alexander_poly(band, alexander_engine::hessenberg), alexander_poly(band, alexander_engine::modular));
+}
+
+void TestExactWidth()
+{
+    square_matrix<int> small(2);
+    small(0, 0) = -1; small(0, 1) = 1; small(1, 1) = 1;
+    EXPECT_TRUE(exact_width(small) == integer_width::int64);
+
+    square_matrix<int> medium(4);
+    for (std::size_t i = 0; i != medium.dim(); ++i) { medium(i, i) = 1000; }
+    EXPECT_TRUE(exact_width(medium) == integer_width::int128);
+
+    square_matrix<int> large(40);
+    for (std::size_t i = 0; i != large.dim(); ++i) { large(i, i) = 1; }
+    EXPECT_TRUE(exact_width(large) == integer_width::big);
+}
+
+void TestHugeCoefficients()
+{
+    // p(t) = 1000^20 * (1 - t)^20 has coefficients of about 2^217.
+    square_matrix<int> m(20);
+    for (std::size_t i = 0; i != m.dim(); ++i) { m(i, i) = 1000; }
+
+    bigint scale = 1;
+    for (int i = 0; i != 20; ++i) { scale *= 1000; }
+    alexander_polynomial expected = one_minus_t_to_the(20);
+    for (bigint & c : expected) { c *= scale; }
+
+    EXPECT_EQ(alexander_poly(m, alexander_engine::exact), expected);
+    EXPECT_EQ(alexander_poly(m, alexander_engine::modular), expected);
+}
+
+void TestModularResidues()
+{
+    // p(t) = 1000^20 * (1 - t)^20 has coefficients far beyond long int, but
+    // the residues modulo a single prime are still correct.
+    square_matrix<int> m(20);
+    for (std::size_t i = 0; i != m.dim(); ++i) { m(i, i) = 1000; }
+
+    std::uint64_t const p = 1000003;
+    std::vector<std::uint64_t> res = alexander_poly_mod(m, p);
+
+    modular::field_guard guard(p);
+    modular scale = 1;
+    for (int i = 0; i != 20; ++i) { scale *= 1000; }
+
+    std::vector<modular> expected(1, scale);
+    for (int k = 0; k != 20; ++k)
+    {
+        expected.push_back(0);
+        for (std::size_t i = expected.size() - 1; i != 0; --i) { expected[i] -= expected[i - 1]; }
+    }
+
+    EXPECT_EQ(alexander_poly_hessenberg_mod(m, p), res);
+    EXPECT_EQ(res.size(), 21u);
+    for (std::size_t k = 0; k != res.size(); ++k)
+    {
+        EXPECT_EQ(res[k], expected[k].value());
+    }
+}
+
+void TestModularMultiplePrimes()
+{
+    // A tridiagonal matrix with diagonal 1 and superdiagonal a has
+    // p(t) = D_d, where D_0 = 1, D_1 = 1 - t and
+    // D_k = (1 - t) D_{k-1} + a^2 t D_{k-2}. The coefficient bound requires
+    // two primes.
+    long int const a = 100;
+    std::size_t const d = 8;
+
+    square_matrix<int> m(d);
+    for (std::size_t i = 0; i != d; ++i) { m(i, i) = 1; }
+    for (std::size_t i = 0; i + 1 != d; ++i) { m(i, i + 1) = a; }
+
+    std::vector<long int> prev(1, 1), cur = { 1, -1 };
+    for (std::size_t k = 2; k <= d; ++k)
+    {
+        std::vector<long int> next(k + 1, 0);
+        for (std::size_t i = 0; i != cur.size(); ++i)  { next[i] += cur[i]; next[i + 1] -= cur[i]; }
+        for (std::size_t i = 0; i != prev.size(); ++i) { next[i + 1] += a * a * prev[i]; }
+        prev.swap(cur);
+        cur.swap(next);
+    }
+
+    EXPECT_EQ(alexander_poly(m, alexander_engine::modular), alexander_polynomial(cur.begin(), cur.end()));
+    EXPECT_EQ(alexander_poly(m, alexander_engine::exact), alexander_polynomial(cur.begin(), cur.end()));
+    EXPECT_EQ(alexander_poly(m, alexander_engine::sparse), alexander_polynomial(cur.begin(), cur.end()));
+    EXPECT_EQ(alexander_poly(m, alexander_engine::hessenberg), alexander_polynomial(cur.begin(), cur.end()));
+}
+
+void TestSymmetricInterpolation()
+{
+    // Large primes use about half of the evaluation points; small ones use
+    // all of them. Both agree with the characteristic polynomial, for odd and
+    // even dimensions.
+    for (std::size_t d : { 1, 2, 7, 30, 31 })
+    {
+        square_matrix<int> m = banded(d);
+        for (std::uint64_t p : { std::uint64_t(101), std::uint64_t(1000003) })
+        {
+            std::vector<std::uint64_t> const expected = alexander_poly_hessenberg_mod(m, p);
+            EXPECT_EQ(alexander_poly_mod(m, p), expected);
+            EXPECT_EQ(alexander_poly_mod(sparse_matrix<int>(m), p), expected);
+        }
+    }
+}
+
+void TestSparse()
+{
+    // The sparse residues agree with the dense ones.
+    square_matrix<int> m = banded(30);
+
+    std::uint64_t const p = 1000003;
+    EXPECT_EQ(alexander_poly_mod(sparse_matrix<int>(m), p), alexander_poly_mod(m, p));
+    EXPECT_EQ(alexander_poly(sparse_matrix<int>(m), alexander_engine::sparse),
+              alexander_poly(m, alexander_engine::modular));
+
+    // A long chain, far beyond what dense elimination could handle. As in
+    // TestModularMultiplePrimes (with a = 1), D_k = (1 - t) D_{k-1} + t D_{k-2},
+    // and D_d is symmetric since d is even.
+    std::size_t const big = 1000;
+    std::vector<sparse_matrix<int>::entry> entries;
+    for (std::size_t i = 0; i != big; ++i)
+    {
+        entries.push_back({ i, i, 1 });
+        if (i + 1 != big) { entries.push_back({ i, i + 1, 1 }); }
+    }
+    std::vector<std::uint64_t> res = alexander_poly_mod(sparse_matrix<int>(big, big, entries), p);
+
+    modular::field_guard guard(p);
+    std::vector<modular> prev(1, 1), expected = { 1, -1 };
+    for (std::size_t k = 2; k <= big; ++k)
+    {
+        std::vector<modular> next(k + 1, 0);
+        for (std::size_t i = 0; i != expected.size(); ++i) { next[i] += expected[i]; next[i + 1] -= expected[i]; }
+        for (std::size_t i = 0; i != prev.size(); ++i)     { next[i + 1] += prev[i]; }
+        prev.swap(expected);
+        expected.swap(next);
+    }
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i != expected.size(); ++i)
+        if (i >= res.size() || expected[i].value() != res[i]) { ++mismatches; }
+    EXPECT_EQ(res.size(), big + 1);
+    EXPECT_EQ(mismatches, 0U);
+}
+
+void TestBurau()
+{
+    // The knots of TestSmallKnots, from their braid words.
+    EXPECT_EQ(burau_of("AbAb"), alexander_polynomial({ -1, 3, -1 }));
+    EXPECT_EQ(burau_of("AAA"), alexander_polynomial({ 1, -1, 1 }));
+    EXPECT_EQ(burau_of("AbCdAbCd"), alexander_polynomial({ 1, -7, 13, -7, 1 }));
+
+    // Odd dimension: the (2, 4) torus link "AAAA", with M = [-1 0 0; 1 -1 0; 0 1 -1].
+    EXPECT_EQ(burau_of("AAAA"), alexander_poly(make_matrix({{-1, 0, 0}, {1, -1, 0}, {0, 1, -1}}), alexander_engine::exact));
+    EXPECT_EQ(burau_of(""), alexander_polynomial(1, 1));
+    EXPECT_EQ(burau_of("Aa"), alexander_polynomial(2, 0));
+
+    // Random braids agree with their Seifert matrices.
+    std::mt19937 rng(1);
+    for (int trial = 0; trial != 100; ++trial)
+    {
+        unsigned int const strands = rng() % 6 + 2;
+        pretzel pr;
+        for (unsigned int i = 1; i != strands; ++i) { pr.emplace_back(i, rng() % 2 ? 1 : -1); }
+        for (int i = 0, n = rng() % 30; i != n; ++i) { pr.emplace_back(rng() % (strands - 1) + 1, rng() % 3 ? 1 : -1); }
+        std::shuffle(pr.begin(), pr.end(), rng);
+
+        EXPECT_EQ(alexander_poly_burau(pr), alexander_poly(compute_seifert_matrix(pr), alexander_engine::modular));
+    }
+
+    // A long braid, with coefficients beyond one prime, and the same residues.
+    pretzel pr;
+    for (int i = 0; i != 200; ++i) { pr.emplace_back(rng() % 4 + 1, 1); }
+    sparse_matrix<int> const sm = compute_sparse_seifert_matrix(pr);
+    EXPECT_EQ(alexander_poly_burau(pr), alexander_poly(sm, alexander_engine::sparse));
+
+    std::uint64_t const p = large_primes(1).front();
+    EXPECT_TRUE(burau_prime_suitable(pr, p));
+    EXPECT_EQ(alexander_poly_burau_mod(pr, p), alexander_poly_mod(sm, p));
+
+    // Modulo 7, the point 2 is a cube root of unity, so "ABA" (with d = 1 and
+    // the evaluation point 2) cannot use it, but it can use 11.
+    pretzel aba;
+    parse_string_as_pretzel("ABA", &aba);
+    EXPECT_FALSE(burau_prime_suitable(aba, 7));
+    EXPECT_TRUE(burau_prime_suitable(aba, 11));
+    EXPECT_EQ(alexander_poly_burau_mod(aba, 11), alexander_poly_mod(compute_seifert_matrix(aba), 11));
+
+    set_parallelism(4);
+    EXPECT_EQ(alexander_poly_burau_mod(pr, p), alexander_poly_mod(sm, p));
+    set_parallelism(1);
+}
+
+void TestParallel()
+{
+    // The results do not depend on the number of threads.
+    square_matrix<int> small = banded(12), large = banded(60);
+    std::uint64_t const p = 1000003;
+
+    std::vector<alexander_polynomial> serial;
+    for (alexander_engine engine : all_engines) { serial.push_back(alexander_poly(small, engine)); }
+    alexander_polynomial serial_large = alexander_poly(large, alexander_engine::modular);
+    std::vector<std::uint64_t> serial_residues = alexander_poly_mod(sparse_matrix<int>(large), p);
+
+    set_parallelism(4);
+    for (std::size_t i = 0; i != serial.size(); ++i) { EXPECT_EQ(alexander_poly(small, all_engines[i]), serial[i]); }
+    EXPECT_EQ(alexander_poly(large, alexander_engine::exact), serial_large);
+    EXPECT_EQ(alexander_poly(large, alexander_engine::modular), serial_large);
+    EXPECT_EQ(alexander_poly(large, alexander_engine::hessenberg), serial_large);
+    EXPECT_EQ(alexander_poly(large, alexander_engine::sparse), serial_large);
+    EXPECT_EQ(alexander_poly_mod(sparse_matrix<int>(large), p), serial_residues);
+    set_parallelism(1);
+}
+
+int main()
+{
+    TestParseEngine();
+    TestSmallKnots();
+    TestLargeDimension();
+    TestHessenberg();
+    TestFFT();
+    TestExactWidth();
+    TestHugeCoefficients();
+    TestModularResidues();
+    TestModularMultiplePrimes();
+    TestSymmetricInterpolation();
+    TestSparse();
+    TestBurau();
+    TestParallel();
+}
@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <functional>
 #include <map>
+#include <tuple>
 
 #include "algorithms.hpp"
 #include "contract.hpp"
@@ -10,30 +12,69 @@ namespace
     {
         return a < b ? b - a : a - b;
     }
+
+    // The strand numbers of the twists, which are all that some of the
+    // algorithms read. The algorithms are templates over these views, so that
+    // they run directly on the strand array of a compact pretzel.
+    struct view_strands
+    {
+        pretzel_view pr;
+        std::size_t size() const { return pr.size(); }
+        unsigned int operator[](std::size_t i) const { return pr[i].first; }
+    };
+
+    struct compact_strands
+    {
+        compact_pretzel const & cp;
+        std::size_t size() const { return cp.size(); }
+        unsigned int operator[](std::size_t i) const { return cp.strands()[i]; }
+    };
+
+    template <typename Strands>
+    std::size_t count_strands(Strands const & strands)
+    {
+        unsigned int highest = 0;
+        for (std::size_t i = 0; i != strands.size(); ++i) { highest = std::max(highest, strands[i]); }
+        return highest + 1;
+    }
+
+    template <typename Strands>
+    index_list find_missing_strands(Strands const & strands)
+    {
+        std::size_t num_strands = count_strands(strands);
+
+        index_list result;
+        scratch_vector<bool> have_strand(num_strands);
+        for (std::size_t i = 0; i != strands.size(); ++i) { have_strand[strands[i] - 1] = true; }
+        for (std::size_t i = 0; i != num_strands - 1; ++i)
+        {
+            if (!have_strand[i]) { result.push_back(i + 1); }
+        }
+        return result;
+    }
 }
 
-std::size_t number_of_strands(pretzel const & pr)
+std::size_t number_of_strands(pretzel_view pr)
 {
-    if (pr.empty()) { return 1; }
+    return count_strands(view_strands{pr});
+}
 
-    return 1 + std::max_element(pr.begin(), pr.end())->first;
+std::size_t number_of_strands(compact_pretzel const & cp)
+{
+    return count_strands(compact_strands{cp});
 }
 
-std::vector<std::size_t> missing_strands(pretzel const & pr)
+index_list missing_strands(pretzel_view pr)
 {
-    std::size_t num_strands = number_of_strands(pr);
+    return find_missing_strands(view_strands{pr});
+}
 
-    std::vector<std::size_t> result;
-    std::vector<bool> have_strand(num_strands);
-    for (auto const & tw : pr) { have_strand[tw.first - 1] = true; }
-    for (std::size_t i = 0; i != num_strands - 1; ++i)
-    {
-        if (!have_strand[i]) { result.push_back(i + 1); }
-    }
-    return result;
+index_list missing_strands(compact_pretzel const & cp)
+{
+    return find_missing_strands(compact_strands{cp});
 }
 
-void partition_twists(std::vector<std::size_t> const & missing, pretzel * pr)
+void partition_twists(index_list const & missing, pretzel * pr)
 {
     auto it = pr->begin();
     for (std::size_t n : missing)
@@ -43,10 +84,10 @@ void partition_twists(std::vector<std::size_t> const & missing, pretzel * pr)
     }
 }
 
-std::vector<std::pair<pretzel::const_iterator, pretzel::const_iterator>>
-group_pretzel_components(std::vector<std::size_t> const & missing, pretzel const & pr)
+component_list
+group_pretzel_components(index_list const & missing, pretzel const & pr)
 {
-    std::vector<std::pair<pretzel::const_iterator, pretzel::const_iterator>> result;
+    component_list result;
 
     auto mt = missing.begin(), me = missing.end();
     auto pt1 = pr.begin(), pt2 = pt1, pe = pr.end();
@@ -77,35 +118,88 @@ pretzel make_subpretzel(pretzel::const_iterator it, pretzel::const_iterator last
     return pr;
 }
 
-std::vector<std::size_t> strand_permutations(pretzel const & pr)
-// The algorithm follows each strand in turn through the braid to see where its
-// final position is. For example, if we are following strand 2 and we see a
-// crossing labelled '1', then we know that strand 2 will switch places with
-// strand 1. If the crossing is labelled '2' then strand 2 will switch places
-// with strand 3. Any other number will leave strand 2 as strand 2.
+scratch_vector<pretzel_view> split_pretzel_components(pretzel * pr)
 {
-    std::size_t num_strands = number_of_strands(pr);
+    std::size_t const num_strands = number_of_strands(*pr);
+
+    // The group of each strand is the number of missing strands below it; the
+    // group that starts after the missing strand m has offset m.
+    scratch_vector<bool> have_strand(num_strands, false);
+    for (twist const & tw : *pr) { have_strand[tw.first - 1] = true; }
+
+    index_list group(num_strands, 0), offsets(1, 0);
+    for (std::size_t i = 0; i + 1 < num_strands; ++i)
+    {
+        group[i] = offsets.size() - 1;
+        if (!have_strand[i]) { offsets.push_back(i + 1); }
+    }
 
-    std::vector<std::size_t> strand_permutation;
-    strand_permutation.reserve(num_strands);
+    // A stable counting sort of the twists by group.
+    index_list start(offsets.size() + 1, 0);
+    for (twist const & tw : *pr) { ++start[group[tw.first - 1] + 1]; }
+    for (std::size_t g = 1; g != start.size(); ++g) { start[g] += start[g - 1]; }
 
-    for (std::size_t n = 1; n <= num_strands; ++n)
+    if (offsets.size() != 1)
     {
-        std::size_t m = n;
-        for (auto const & tw : pr)
+        pretzel sorted(pr->size());
+        index_list fill(start);
+        for (twist const & tw : *pr) { sorted[fill[group[tw.first - 1]]++] = tw; }
+        pr->swap(sorted);
+    }
+
+    scratch_vector<pretzel_view> result;
+    for (std::size_t g = 0; g != offsets.size(); ++g)
+    {
+        twist const * const data = pr->data();
+        result.emplace_back(data + start[g], data + start[g + 1], offsets[g]);
+    }
+    return result;
+}
+
+namespace
+{
+    // Follows all strands through the pretzel at once: every twist swaps the
+    // strands at its two positions, since its twisting number is odd. Returns
+    // the strand permutation (see strand_permutations()); if "meets" is not
+    // null, appends to it the two incoming strands that meet in each twist.
+    template <typename Strands>
+    index_list trace_strands(Strands const & strands, scratch_vector<std::pair<std::size_t, std::size_t>> * meets)
+    {
+        std::size_t const num_strands = count_strands(strands);
+
+        // The incoming strand at each position.
+        index_list at(num_strands);
+        for (std::size_t p = 0; p != num_strands; ++p) { at[p] = p + 1; }
+
+        for (std::size_t i = 0; i != strands.size(); ++i)
         {
-            if      (tw.first     == m) { ++m; }
-            else if (tw.first + 1 == m) { --m; }
+            unsigned int const st = strands[i];
+            if (meets) { meets->emplace_back(at[st - 1], at[st]); }
+            std::swap(at[st - 1], at[st]);
         }
-        strand_permutation.push_back(m);
+
+        index_list strand_permutation(num_strands);
+        for (std::size_t p = 0; p != num_strands; ++p) { strand_permutation[at[p] - 1] = p + 1; }
+        return strand_permutation;
     }
+}
+
+index_list strand_permutations(pretzel_view pr)
+// Rather than following each strand in turn through the braid, we follow all
+// of them at once: a crossing labelled 'n' swaps the strands at positions n
+// and n + 1 and leaves all other strands where they are.
+{
+    return trace_strands(view_strands{pr}, nullptr);
+}
 
-    return strand_permutation;
+index_list strand_permutations(compact_pretzel const & cp)
+{
+    return trace_strands(compact_strands{cp}, nullptr);
 }
 
-std::size_t count_permutation_cycles(std::vector<std::size_t> const & permutation)
+std::size_t count_permutation_cycles(index_list const & permutation)
 {
-    std::vector<bool> visited(permutation.size(), false);
+    scratch_vector<bool> visited(permutation.size(), false);
     std::size_t count = 0;
 
     for (std::size_t i = 0; i != permutation.size(); ++i)
@@ -124,85 +218,148 @@ std::size_t count_permutation_cycles(std::vector<std::size_t> const & permutatio
   return count;
 }
 
-std::vector<std::size_t> compute_homology(pretzel const & pr)
-// The algorithm takes each crossing in turn and looks through the braid to find
-// the next crossing with the same modulus. This is because the modulus of the
-// crossing tells us between which strands it lies.
+link_components compute_link_components(pretzel_view pr)
 {
-    std::vector<std::size_t> homology;
+    link_components result;
+    result.permutation = trace_strands(view_strands{pr}, &result.twist_components);
+
+    // Label the cycles in the order of their smallest strands.
+    std::size_t const none = std::size_t(-1);
+    result.count = 0;
+    result.strand_component.assign(result.permutation.size(), none);
+    for (std::size_t i = 0; i != result.permutation.size(); ++i)
+    {
+        if (result.strand_component[i] != none) { continue; }
 
-    if (pr.empty()) { return homology; }
+        for (std::size_t k = i; result.strand_component[k] == none; k = result.permutation[k] - 1)
+        {
+            result.strand_component[k] = result.count;
+        }
 
-    homology.resize(pr.size() - 1, 0);
+        ++result.count;
+    }
 
-    for (std::size_t i = 0; i != homology.size(); ++i)
+    for (auto & meet : result.twist_components)
+    {
+        meet.first = result.strand_component[meet.first - 1];
+        meet.second = result.strand_component[meet.second - 1];
+    }
+
+    return result;
+}
+
+namespace
+{
+    template <typename Strands>
+    index_list find_homology(Strands const & strands)
     {
-        for (std::size_t j = i; homology[i] == 0 && j < homology.size(); )
+        index_list homology;
+
+        if (strands.size() == 0) { return homology; }
+
+        homology.resize(strands.size() - 1, 0);
+
+        index_list next_seen(count_strands(strands), 0);
+        for (std::size_t i = strands.size(); i-- != 0; )
         {
-            ++j;
-            if (pr[i].first == pr[j].first) { homology[i] = j + 1; }
+            std::size_t & next = next_seen[strands[i] - 1];
+            if (i != homology.size()) { homology[i] = next; }
+            next = i + 1;
         }
+
+        return homology;
     }
+}
 
-    return homology;
+index_list compute_homology(pretzel_view pr)
+// Each crossing is adjacent to the next crossing with the same modulus, since
+// the modulus of the crossing tells us between which strands it lies. Scanning
+// the braid backwards, a table of the next crossing on each strand finds all
+// of them in linear time.
+{
+    return find_homology(view_strands{pr});
 }
 
-square_matrix<int> compute_seifert_matrix(pretzel const & pr)
-// The algorithm follows the paper by Julia Collins ("An algorithm for computing
-// the Seifert matrix of a link from a braid representation", section 3).
+index_list compute_homology(compact_pretzel const & cp)
 {
-    std::vector<size_t> homology = compute_homology(pr);
+    return find_homology(compact_strands{cp});
+}
 
-    square_matrix<int> sm(homology.size(), 0);
+sparse_matrix<int> compute_sparse_seifert_matrix(pretzel_view pr)
+// The algorithm follows the paper by Julia Collins ("An algorithm for computing
+// the Seifert matrix of a link from a braid representation", section 3). Of
+// the cases in section 3.3, only two produce entries for a pair of distinct
+// crossings i < j (both with homology, on strands s and t):
+//
+//    - case 3: j is the next crossing after i on strand s;
+//    - case 5: t = s +/- 1, i < j < h(i) - 1 < h(j) - 1, i.e. j is the last
+//      crossing on strand t before the next crossing on strand s.
+//
+// So the pairs can be found in a single pass over the braid that remembers
+// the last crossing on each strand, in time proportional to the length of the
+// braid (and to the number of non-zero entries).
+{
+    index_list homology = compute_homology(pr);
 
+    // Crossings without homology would only contribute zero rows and columns,
+    // so the matrix is built without them: row and column a belong to crossing
+    // nonzero[a], and crossing i to row[i].
+    index_list nonzero, row(homology.size());
     for (std::size_t i = 0; i != homology.size(); ++i)
     {
-        if (!homology[i]) { continue; }
+        if (homology[i]) { row[i] = nonzero.size(); nonzero.push_back(i); }
+    }
+    auto has_homology = [&homology](std::size_t i) { return i < homology.size() && homology[i] != 0; };
+
+    scratch_vector<sparse_matrix<int>::entry> entries;
+    auto set = [&entries](std::size_t a, std::size_t b, long int value)
+    {
+        entries.push_back({ a, b, static_cast<int>(value) });
+    };
 
-        for (std::size_t j = i; j != homology.size(); ++j)
-        {
-            // Self-linking
-            if (i == j) { sm(i, j) = -(pr[i].second + pr[homology[i] - 1].second) / 2; }
+    // Self-linking (the sums are formed in long to avoid overflow; the results
+    // always fit into int).
+    for (std::size_t a = 0; a != nonzero.size(); ++a)
+    {
+        std::size_t const i = nonzero[a];
+        set(a, a, -(long(pr[i].second) + pr[homology[i] - 1].second) / 2);
+    }
 
-            // See Section 3.3 case 1
-            else if (homology[i] > homology[j])              { /* nothing */ }
+    // Position plus one of the last crossing on each strand, with room for
+    // the strands on either side.
+    index_list last_seen(number_of_strands(pr) + 1, 0);
+    for (std::size_t k = 0; k != pr.size(); ++k)
+    {
+        unsigned int const s = pr[k].first;
+        std::size_t & last = last_seen[s];
 
-            // See Section 3.3 case 2
-            else if (homology[i] < j + 1)                    { /* nothing */ }
+        // The previous crossing i on strand s has h(i) - 1 == k.
+        if (last != 0)
+        {
+            std::size_t const i = last - 1;
 
             // See Section 3.3 case 3
-            else if (homology[i] == j + 1)
+            if (has_homology(k))
             {
-                sm(i, j) = (pr[j].second - 1) / 2;
-                sm(j, i) = (pr[j].second + 1) / 2;
+                set(row[i], row[k], (long(pr[k].second) - 1) / 2);
+                set(row[k], row[i], (long(pr[k].second) + 1) / 2);
             }
 
-            // See Section 3.3 case 4
-            else if (abs_diff(pr[i].first, pr[j].first) > 1) { /* nothing */ }
-
             // See Section 3.3 case 5
-            else if (pr[i].first == 1 + pr[j].first) { sm(j, i) = -1; }
-            else if (pr[i].first + 1 == pr[j].first) { sm(i, j) =  1; }
-
-            else
-            {
-                CHECK(false, "Error in Seifert matrix algorithm");
-            }
+            std::size_t const below = last_seen[s - 1], above = last_seen[s + 1];
+            if (below > last && has_homology(below - 1)) { set(row[below - 1], row[i], -1); }
+            if (above > last && has_homology(above - 1)) { set(row[i], row[above - 1], 1); }
         }
-    }
 
-    // Remove zero rows and columns.
-    for (std::size_t i = 0, N = sm.dim(); i != N; ++i)
-    {
-        std::size_t const ri = N - i - 1;
-        if (homology[ri] == 0)
-        {
-            if (sm.rows() != 0) { sm.remove_row(ri); }
-            if (sm.cols() != 0) { sm.remove_col(ri); }
-        }
+        last = k + 1;
     }
 
-    return sm;
+    return sparse_matrix<int>(nonzero.size(), nonzero.size(), std::move(entries));
+}
+
+square_matrix<int> compute_seifert_matrix(pretzel_view pr)
+{
+    return compute_sparse_seifert_matrix(pr).to_dense();
 }
 
 
@@ -210,84 +367,350 @@ square_matrix<int> compute_seifert_matrix(pretzel const & pr)
 
 namespace
 {
-    // "CA" => "AC""
+    // A pretzel from which twists can be erased in constant time, for the
+    // simplification steps. The twists keep their places in the underlying
+    // array and are linked in order; since no twists are ever inserted, the
+    // positions of the remaining ones are increasing along the list, too.
+    // Strand numbers are shifted by "offset", so that trimming the lowest
+    // strand need not renumber all the others.
+    //
+    // The list also holds the state of the current search for a rearrangement
+    // (see produce_via_yb()): the number of twists that it may still examine,
+    // the twists at which it stopped, and the nested searches known to have
+    // failed since the last change.
+    class linked_pretzel
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = twist;
+            using difference_type = std::ptrdiff_t;
+            using pointer = twist *;
+            using reference = twist &;
+
+            iterator(linked_pretzel * lp, std::size_t pos) : lp_(lp), pos_(pos) { }
+
+            twist & operator*() const { return lp_->twists_[pos_]; }
+            twist * operator->() const { return &lp_->twists_[pos_]; }
+
+            iterator & operator++() { pos_ = lp_->next_[pos_]; return *this; }
+            iterator operator++(int) { iterator r(*this); ++*this; return r; }
+
+            bool operator==(iterator const & rhs) const { return pos_ == rhs.pos_; }
+            bool operator!=(iterator const & rhs) const { return pos_ != rhs.pos_; }
+
+            std::size_t position() const { return pos_; }
+            linked_pretzel & owner() const { return *lp_; }
+
+        private:
+            linked_pretzel * lp_;
+            std::size_t pos_;
+        };
+
+        // The list is circular through the end position, twists_.size().
+        linked_pretzel(pretzel const & pr, std::size_t search_budget)
+        : offset(0), reach(0), budget(0), exhausted(false), recalled(false), rewritten(false),
+          search_budget_(search_budget),
+          twists_(pr), next_(pr.size() + 1), prev_(pr.size() + 1), last_on_(number_of_strands(pr) + 2, 0)
+        {
+            std::size_t const n = pr.size() + 1;
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                next_[i] = (i + 1) % n;
+                prev_[i] = (i + n - 1) % n;
+            }
+
+            for (std::size_t i = 0; i != pr.size(); ++i) { last_on_[pr[i].first] = i; }
+        }
+
+        iterator begin() { return iterator(this, next_[twists_.size()]); }
+        iterator end()   { return iterator(this, twists_.size()); }
+        iterator at(std::size_t pos) { return iterator(this, pos); }
+
+        // Returns the iterator following the erased twist.
+        iterator erase(iterator it)
+        {
+            std::size_t const pos = it.position();
+            next_[prev_[pos]] = next_[pos];
+            prev_[next_[pos]] = prev_[pos];
+            changed();
+            return iterator(this, next_[pos]);
+        }
+
+        // Records that a search has examined the twist at "it" (or has run to
+        // the end), see cancel_inverses().
+        void examined(iterator it) { examined(it.position()); }
+        void examined(std::size_t pos) { reach = std::max(reach, pos); }
+
+        // Starts a search with a fresh budget, see find_distant().
+        void start_search()
+        {
+            budget = search_budget_;
+            exhausted = recalled = rewritten = false;
+            stops.clear();
+        }
+
+        // Must be called whenever the twists change; a failed search does not
+        // change anything, so its outcome remains valid until then.
+        void changed() { failed.clear(); }
+
+        // Must be called when the twist at "it" has been replaced.
+        void rewrote(iterator it)
+        {
+            std::size_t & last = last_on_[it->first];
+            last = std::max(last, it.position());
+        }
+
+        // Returns a position beyond which there is no twist on the strands
+        // st - 1, st and st + 1.
+        std::size_t last_near(unsigned int st) const
+        {
+            return std::max(std::max(last_on_[st - 1], last_on_[st]), last_on_[st + 1]);
+        }
+
+        // Stores the remaining twists in *p, with their actual strand numbers.
+        void store(pretzel * p)
+        {
+            p->clear();
+            for (auto it = begin(); it != end(); ++it) { p->emplace_back(it->first - offset, it->second); }
+        }
+
+        unsigned int offset;
+        std::size_t reach;
+
+        // The number of twists that the current search may still examine, and
+        // whether it has run out. The failed nested searches are keyed on their
+        // strand, twist and starting position, and map to their reach.
+        std::size_t budget;
+        bool exhausted;
+        std::map<std::tuple<unsigned int, int, std::size_t>, std::size_t> failed;
+
+        // The positions of the twists at which the current search stopped
+        // (other than the end), including the one at which it first ran out
+        // of budget; whether it reused a remembered failure, whose stops are not
+        // known; and whether it rewrote twists by YB moves.
+        index_list stops;
+        bool recalled;
+        bool rewritten;
+
+    private:
+        std::size_t search_budget_;
+        pretzel twists_;
+        index_list next_, prev_;
+
+        // For each strand, a position beyond which it has no twists. Erasing
+        // twists keeps this valid, and YB moves update it.
+        index_list last_on_;
+    };
+
+    using lp_iterator = linked_pretzel::iterator;
+
+    // "CA" => "AC". Swapping such pairs until none are left produces the
+    // lexicographically least of all the pretzels that differ from *p only by
+    // the order of commuting twists, i.e. the lexicographic normal form in the
+    // trace monoid (in which twists on strands at least two apart commute).
+    // We compute it directly as the least topological order of the remaining
+    // dependencies: a twist can be placed once all earlier twists on its own
+    // and the adjacent strands have been placed, and each time the lowest
+    // strand with such a twist goes next. With a heap of those strands, this
+    // takes O(n log s) time for n twists on s strands.
     bool commute_distant_elements(pretzel * p)
     {
-        auto it = std::adjacent_find(
-            p->begin(), p->end(),
-            [](twist const & a, twist const & b)
-            { return a.first > b.first + 1; });
-        if (it != p->end()) { std::iter_swap(it, std::next(it)); return true; }
-        return false;
+        std::size_t const n = p->size();
+        std::size_t const num_strands = number_of_strands(*p);
+
+        // For each twist, the numbers of earlier twists on the strands below
+        // and above it; and the twists on each strand, in order (the ones on
+        // strand st are by_strand[start[st]], ..., by_strand[start[st + 1] - 1]).
+        index_list below(n), above(n), count(num_strands + 2, 0);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            unsigned int const st = (*p)[i].first;
+            below[i] = count[st - 1];
+            above[i] = count[st + 1];
+            ++count[st];
+        }
+
+        index_list start(num_strands + 2, 0), by_strand(n);
+        for (std::size_t st = 1; st != start.size(); ++st) { start[st] = start[st - 1] + count[st - 1]; }
+        {
+            index_list fill(start);
+            for (std::size_t i = 0; i != n; ++i) { by_strand[fill[(*p)[i].first]++] = i; }
+        }
+
+        // The number of twists placed so far on each strand, and the strands
+        // whose next twist can be placed, lowest first.
+        index_list placed(num_strands + 2, 0);
+        scratch_vector<unsigned int> ready;
+        scratch_vector<bool> is_ready(num_strands + 2, false);
+        auto const lowest_first = std::greater<unsigned int>();
+
+        auto consider = [&](unsigned int st)
+        {
+            if (st == 0 || st > num_strands || is_ready[st] || placed[st] == count[st]) { return; }
+
+            std::size_t const i = by_strand[start[st] + placed[st]];
+            if (placed[st - 1] < below[i] || placed[st + 1] < above[i]) { return; }
+
+            is_ready[st] = true;
+            ready.push_back(st);
+            std::push_heap(ready.begin(), ready.end(), lowest_first);
+        };
+
+        for (unsigned int st = 1; st <= num_strands; ++st) { consider(st); }
+
+        pretzel result;
+        result.reserve(n);
+        bool progress = false;
+        while (!ready.empty())
+        {
+            std::pop_heap(ready.begin(), ready.end(), lowest_first);
+            unsigned int const st = ready.back();
+            ready.pop_back();
+            is_ready[st] = false;
+
+            std::size_t const i = by_strand[start[st] + placed[st]++];
+            if (i != result.size()) { progress = true; }
+            result.push_back((*p)[i]);
+
+            consider(st - 1);
+            consider(st);
+            consider(st + 1);
+        }
+
+        if (progress) { p->swap(result); }
+        return progress;
     }
 
-    pretzel::iterator find_yb_triple(unsigned int st, int tw, int step, pretzel::iterator it, pretzel::iterator last);
+    lp_iterator find_yb_triple(unsigned int st, int tw, int step, lp_iterator it, lp_iterator last);
 
     // Remove twists from the outside of the pretzel that do not affect the link
     // defined by the pretzel closure. Such twists are characterized by being
     // the unique twist to contain the lowest or highest strand number. If a
     // twist with the lowest strand number is removed, all other strand numbers
     // are decremented by one (otherwise the pretzel would gain a disconnected
-    // unknot).
-    bool trim_lone_twists(pretzel * p)
+    // unknot). Repeats until no more twists can be trimmed.
+    //
+    // The twists on each strand are counted and listed once. Trimming a lone
+    // twist only empties its own strand, so the lists of the others remain
+    // valid and the lowest and highest strands only move inwards; only a YB
+    // move, which changes strands, requires a recount. So each trim takes
+    // constant time.
+    bool trim_lone_twists(linked_pretzel * lp)
     {
-        std::map<unsigned int, unsigned int> twistogram;
-        for (twist const & tw : *p) { ++twistogram[tw.first]; }
-        if (twistogram.empty()) { return false; }
+        // The number of twists on each strand, and their positions in order:
+        // those on strand st are at[start[st]], ..., at[start[st + 1] - 1].
+        // Strands lowest, ..., highest - 1 contain all remaining twists.
+        index_list twistogram, start, at;
+        std::size_t lowest = 0, highest = 0;
+
+        auto recount = [&]() {
+            twistogram.clear();
+            for (twist const & tw : *lp)
+            {
+                if (twistogram.size() <= tw.first) { twistogram.resize(tw.first + 1, 0); }
+                ++twistogram[tw.first];
+            }
+
+            start.assign(twistogram.size() + 1, 0);
+            for (std::size_t st = 0; st != twistogram.size(); ++st) { start[st + 1] = start[st] + twistogram[st]; }
 
-        auto trim_finder = [](pretzel * q, unsigned int st) {
-            return std::find_if(q->begin(), q->end(), [st](twist const & tw) { return tw.first == st; });
+            index_list fill(start);
+            at.resize(start.back());
+            for (auto it = lp->begin(); it != lp->end(); ++it) { at[fill[it->first]++] = it.position(); }
+
+            lowest = 0;
+            highest = twistogram.size();
         };
+        recount();
 
-        // Lowest twist is unique.
-        if (twistogram.begin()->second == 1)
-        {
-            p->erase(trim_finder(p, twistogram.begin()->first));
-            for (auto & tw : *p) { --tw.first; }
-            return true;
-        }
+        auto const first_on = [&](std::size_t st) { return lp->at(at[start[st]]); };
 
-        // Highest twist is unique.
-        if (twistogram.rbegin()->second == 1)
+        for (bool progress = false; ; progress = true)
         {
-            p->erase(trim_finder(p, twistogram.rbegin()->first));
-            return true;
-        }
+            while (lowest != highest && twistogram[lowest] == 0)      { ++lowest;  }
+            while (lowest != highest && twistogram[highest - 1] == 0) { --highest; }
+            if (lowest == highest) { return progress; }
 
-        // Extreme strand occurs twice and is a braid twist; check whether there
-        // is a YB relation that makes the strand unique (e.g. "ZYZ" => "YZY").
-        if (twistogram.begin()->second == 2)
-        {
-            auto it = trim_finder(p, twistogram.begin()->first);
-            if (it->second == 1 || it->second == -1)
+            std::size_t const top = highest - 1;
+
+            // Lowest twist is unique.
+            if (twistogram[lowest] == 1)
             {
-                auto kt = find_yb_triple(it->first + 1, it->second, -1, it, p->end());
-                if (kt != p->end()) { return true; }
+                lp->erase(first_on(lowest));
+                --twistogram[lowest];
+                ++lp->offset;
+                continue;
             }
-        }
-        if (twistogram.rbegin()->second == 2 && twistogram.rbegin()->first > 1)
-        {
-            auto it = trim_finder(p, twistogram.rbegin()->first);
-            if (it->second == 1 || it->second == -1)
+
+            // Highest twist is unique.
+            if (twistogram[top] == 1)
             {
-                auto kt = find_yb_triple(it->first - 1, it->second, +1, it, p->end());
-                if (kt != p->end()) { return true; }
+                lp->erase(first_on(top));
+                --twistogram[top];
+                continue;
+            }
+
+            // Extreme strand occurs twice and is a braid twist; check whether there
+            // is a YB relation that makes the strand unique (e.g. "ZYZ" => "YZY").
+            if (twistogram[lowest] == 2)
+            {
+                auto it = first_on(lowest);
+                if (it->second == 1 || it->second == -1)
+                {
+                    lp->start_search();
+                    auto kt = find_yb_triple(it->first + 1, it->second, -1, it, lp->end());
+                    if (kt != lp->end()) { recount(); continue; }
+                }
+            }
+            if (twistogram[top] == 2 && top - lp->offset > 1)
+            {
+                auto it = first_on(top);
+                if (it->second == 1 || it->second == -1)
+                {
+                    lp->start_search();
+                    auto kt = find_yb_triple(it->first - 1, it->second, +1, it, lp->end());
+                    if (kt != lp->end()) { recount(); continue; }
+                }
             }
-        }
 
-        return false;
+            return progress;
+        }
     }
 
     // Find a twist (st, tw) in the range [it, last) that can be commuted to the
-    // beginning of the range; returns last if no such twist exists.
-    pretzel::iterator find_distant(unsigned int st, int tw, pretzel::iterator it, pretzel::iterator last)
+    // beginning of the range; returns last if no such twist exists. Every twist
+    // examined counts against the budget of the current search; once that is
+    // spent, all further searches fail, so that the simplification is merely
+    // less thorough. The search ends early after the last twist that could
+    // stop it.
+    lp_iterator find_distant(unsigned int st, int tw, lp_iterator it, lp_iterator last)
     {
-        for (; it != last; ++it)
+        linked_pretzel & lp = last.owner();
+        std::size_t const limit = lp.last_near(st);
+        for (; it != last && it.position() <= limit; ++it)
         {
-            if (it->first == st && it->second == tw) { return it; }
-            if (abs_diff(it->first, st) < 2) { return last; }
+            if (lp.budget == 0)
+            {
+                if (!lp.exhausted) { lp.stops.push_back(it.position()); }
+                lp.exhausted = true;
+                lp.examined(it);
+                return last;
+            }
+            --lp.budget;
+
+            bool const found = it->first == st && it->second == tw;
+            if (found || abs_diff(it->first, st) < 2)
+            {
+                lp.examined(it);
+                lp.stops.push_back(it.position());
+                return found ? it : last;
+            }
         }
 
+        lp.examined(last);
         return last;
     }
 
@@ -295,8 +718,8 @@ namespace
     // be commuted to the beginning of the range by applying YB relations. If no
     // such rearrangement can be performed, returns last; otherwise performs the
     // rearrangement and returns the iterator pointint to the newly produced ele-
-    // ment (st, tw).
-    pretzel::iterator produce_via_yb(unsigned int st, int tw, pretzel::iterator it, pretzel::iterator last)
+    // ment (st, tw). The caller starts the search (see linked_pretzel).
+    lp_iterator produce_via_yb(unsigned int st, int tw, lp_iterator it, lp_iterator last)
     {
         // Base case
         {
@@ -311,7 +734,7 @@ namespace
         }
 
         // Try YB below ("C" searches for "BCB")
-        if (st > 1)
+        if (st > it.owner().offset + 1)
         {
             auto kt = find_yb_triple(st, tw, -1, it, last);
             if (kt != last) { return kt; }
@@ -320,7 +743,32 @@ namespace
         return last;
     }
 
-    pretzel::iterator find_yb_triple(unsigned int st, int tw, int step, pretzel::iterator it, pretzel::iterator last)
+    // The nested searches of different twists often arrive at the same place,
+    // so their failures are remembered (together with their reach, which
+    // cancel_inverses() relies on). A search that ran out of budget has not
+    // really failed and is not remembered.
+    lp_iterator produce_nested(unsigned int st, int tw, lp_iterator it, lp_iterator last)
+    {
+        linked_pretzel & lp = last.owner();
+        auto const key = std::make_tuple(st, tw, it.position());
+
+        auto const known = lp.failed.find(key);
+        if (known != lp.failed.end())
+        {
+            lp.examined(known->second);
+            lp.recalled = true;
+            return last;
+        }
+
+        std::size_t const outer_reach = lp.reach;
+        lp.reach = 0;
+        auto kt = produce_via_yb(st, tw, it, last);
+        if (kt == last && !lp.exhausted) { lp.failed.emplace(key, lp.reach); }
+        lp.examined(outer_reach);
+        return kt;
+    }
+
+    lp_iterator find_yb_triple(unsigned int st, int tw, int step, lp_iterator it, lp_iterator last)
     {
         auto kt1 = find_distant(st + step, tw, it, last);
         if (kt1 != last)
@@ -328,11 +776,18 @@ namespace
             auto kt2 = find_distant(st, tw, std::next(kt1), last);
             if (kt2 != last)
             {
-                auto kt3 = produce_via_yb(st + step, tw, std::next(kt2), last);
+                auto kt3 = produce_nested(st + step, tw, std::next(kt2), last);
                 if (kt3 != last)
                 {
                     std::iter_swap(kt2, kt3);
                     *kt1 = *kt3;
+
+                    linked_pretzel & lp = kt1.owner();
+                    lp.rewrote(kt1);
+                    lp.rewrote(kt2);
+                    lp.rewrote(kt3);
+                    lp.changed();
+                    lp.rewritten = true;
                     return kt1;
                 }
             }
@@ -340,39 +795,126 @@ namespace
         return last;
     }
 
-    bool cancel_inverses(pretzel * p)
+    // Cancels braid twists with inverses that can be made adjacent by RM2 moves
+    // ("a...A") or RM3 moves, in the order in which restarting the scan from
+    // the front after every cancellation would find them. A twist for which
+    // no inverse was found is only examined again if the cancellation could
+    // change the outcome of its search, and the scan resumes at the first
+    // such twist:
+    //
+    //    - A search only depends on the twists at which it stopped; it merely
+    //      commutes past all others. So after a plain cancellation, only the
+    //      searches that stopped at one of the two erased twists are affected.
+    //      (A search that ran out of budget is retried only if the twist at
+    //      which it ran out is erased, not whenever it could get further.)
+    //    - A search that reused a remembered nested failure, and every search
+    //      after a cancellation that needed YB moves, is instead treated as
+    //      depending on everything up to its reach, i.e. on the part of the
+    //      pretzel that the change touched (which starts at the cancelled
+    //      twist).
+    bool cancel_inverses(linked_pretzel * lp)
     {
-        for (auto it = p->begin(), e = p->end(); it != e; ++it)
+        // The twists examined in vain, in order, with a serial number and the
+        // maximum positions reached by the searches of any of them up to this
+        // one, and of those of them whose stops are not known.
+        struct failure { std::size_t position, serial, reach, unknown_reach; };
+        scratch_vector<failure> failures;
+        std::size_t serials = 0;
+
+        // For each position, the serial number of the first failure whose
+        // search stopped there. An entry is valid only while that failure is
+        // still listed; failures are only ever removed from the back, so a
+        // later failure that stops at the same place takes over the entry.
+        std::size_t const none = -1;
+        index_list first_stop(lp->end().position() + 1, none);
+
+        // Returns the listed failure with the given serial number, or the end.
+        auto listed = [&failures](std::size_t serial)
+        {
+            auto const f = std::lower_bound(failures.begin(), failures.end(), serial,
+                                            [](failure const & x, std::size_t s) { return x.serial < s; });
+            return f != failures.end() && f->serial == serial ? f : failures.end();
+        };
+
+        auto first_stopped_at = [&](std::size_t pos)
         {
-            if (it->second != 1 && it->second != -1) { continue; }
+            return first_stop[pos] == none ? failures.end() : listed(first_stop[pos]);
+        };
 
-            // Find inverse that's adjacent after RM2 moves ("a...A")
+        bool progress = false;
+        for (auto it = lp->begin(), e = lp->end(); it != e; )
+        {
+            if (it->second != 1 && it->second != -1) { ++it; continue; }
+
+            // The base case of produce_via_yb() is the search for an inverse
+            // that's adjacent after RM2 moves.
+            lp->reach = it.position();
+            lp->start_search();
+            auto kt = produce_via_yb(it->first, -it->second, std::next(it), e);
+            if (kt == e)
             {
-                auto kt = find_distant(it->first, -it->second, std::next(it), e);
-                if (kt != e) { p->erase(kt); p->erase(it); return true; }
+                failure f = { it.position(), serials++, lp->reach, lp->recalled ? lp->reach : 0 };
+                if (!failures.empty())
+                {
+                    f.reach = std::max(f.reach, failures.back().reach);
+                    f.unknown_reach = std::max(f.unknown_reach, failures.back().unknown_reach);
+                }
+                failures.push_back(f);
+
+                for (std::size_t pos : lp->stops)
+                {
+                    if (first_stopped_at(pos) == failures.end()) { first_stop[pos] = f.serial; }
+                }
+
+                ++it;
+                continue;
             }
 
-            // Find inverse that's adjacent after RM3 moves
+            std::size_t const changed = it.position(), partner = kt.position();
+            bool const rewritten = lp->rewritten;
+            lp->erase(kt);
+            it = lp->erase(it);
+            progress = true;
+
+            auto redo = failures.end();
+            if (rewritten)
+            {
+                redo = std::partition_point(failures.begin(), failures.end(),
+                                            [changed](failure const & f) { return f.reach < changed; });
+            }
+            else
             {
-                auto kt = produce_via_yb(it->first, -it->second, std::next(it), e);
-                if (kt != e) { p->erase(kt); p->erase(it); return true; }
+                redo = std::partition_point(failures.begin(), failures.end(),
+                                            [changed](failure const & f) { return f.unknown_reach < changed; });
+                redo = std::min(redo, std::min(first_stopped_at(changed), first_stopped_at(partner)));
+            }
 
+            if (redo != failures.end())
+            {
+                it = lp->at(redo->position);
+                failures.erase(redo, failures.end());
             }
         }
 
-        return false;
+        return progress;
     }
 }
 
-bool simplify(pretzel * p)
+bool simplify(pretzel * p, std::size_t search_budget)
 {
     bool progress = false;
 
-    while (cancel_inverses(p)) { progress = true; }
+    {
+        linked_pretzel lp(*p, search_budget);
+        if (cancel_inverses(&lp)) { progress = true; lp.store(p); }
+    }
 
-    while (commute_distant_elements(p)) { progress = true; }
+    if (commute_distant_elements(p)) { progress = true; }
 
-    while (trim_lone_twists(p)) { progress = true; }
+    {
+        linked_pretzel lp(*p, search_budget);
+        if (trim_lone_twists(&lp)) { progress = true; lp.store(p); }
+    }
 
     return progress;
 }
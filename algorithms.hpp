@@ -3,8 +3,21 @@
 
 #include <vector>
 
+#include "arena.hpp"
+#include "compact_pretzel.hpp"
 #include "matrix.hpp"
 #include "pretzel.hpp"
+#include "sparse_matrix.hpp"
+
+// Lists of strand or crossing numbers. Like pretzels, these take their memory
+// from the current arena, if any (see arena.hpp).
+using index_list = scratch_vector<std::size_t>;
+
+// Ranges of twists of a pretzel, see group_pretzel_components().
+using component_list = scratch_vector<std::pair<pretzel::const_iterator, pretzel::const_iterator>>;
+
+// The default work budget of each search in simplify().
+std::size_t const default_search_budget = 100000;
 
 // Tries to reorder and reduce the pretzel *p to one that determines an isomorphic
 // link. Returns whether any modifications have been made. The resulting pretzel
@@ -21,23 +34,35 @@
 // Conditions 1-3 fix a unique representation of braid words that appear in the
 // pretzel. Condition 4 means that the pretzel does not contain any strands that
 // do not affect the resulting link.
-bool simplify(pretzel * p);
+//
+// Each kind of step is applied until it no longer makes progress. After a
+// change, only the twists whose earlier searches could have a different
+// outcome are examined again, so that long braids simplify in close to linear
+// time.
+//
+// Each search for a rearrangement that lets one twist cancel or be trimmed
+// examines at most "search_budget" twists; if it runs out, the twist is left
+// as it is. The budget is per search, not per call: the total work is bounded
+// by the budget times the number of searches, including the repeated ones. A
+// larger budget finds more simplifications in long pretzels, at the cost of a
+// worst case time that grows with it.
+bool simplify(pretzel * p, std::size_t search_budget = default_search_budget);
 
 // Returns the largest occurring strand number plus one; this is the number of
 // strands in the pretzel. (E.g. the simple pretzel [(1, 1)] has two strands.)
-std::size_t number_of_strands(pretzel const & pr);
+std::size_t number_of_strands(pretzel_view pr);
 
 // Return a list of all the inner strands that are not mentioned by the pretzel.
 // If this list is non-empty, then the link decomposes into a disjoint union of
 // links, since strands on either side of a "missing" strand cannot cross.
 // (However, even if there are no missing strands, a pretzel may still have
 // multiple components.)
-std::vector<std::size_t> missing_strands(pretzel const & pr);
+index_list missing_strands(pretzel_view pr);
 
 // Rearrange the twists in a pretzel into contiguous groups that contain no
 // missing strands (e.g. "1 3 1 3" => "1 1 3 3"). The missing strands must be
 // computed ahead of time and provided as input.
-void partition_twists(std::vector<std::size_t> const & missing, pretzel * pr);
+void partition_twists(index_list const & missing, pretzel * pr);
 
 // Returns a list of sub-ranges of disconnected sub-pretzels of "pr". Requires
 // that "pr" be partitioned according to "missing" as if by invocation of
@@ -45,8 +70,8 @@ void partition_twists(std::vector<std::size_t> const & missing, pretzel * pr);
 // a pretzel properly, since it retains implicit initial strands. For example
 // "BBB" is not the same as "AAA", but rather it is "AAA" plus an unknot. See
 // "make_subpretzel()" below.
-std::vector<std::pair<pretzel::const_iterator, pretzel::const_iterator>>
-group_pretzel_components(std::vector<std::size_t> const & missing, pretzel const & pr);
+component_list
+group_pretzel_components(index_list const & missing, pretzel const & pr);
 
 // Turns a range of twists into a pretzel by moving all the strand numbers up so
 // that the lowest strand number is 1. If the input range was obtained from a
@@ -58,23 +83,66 @@ group_pretzel_components(std::vector<std::size_t> const & missing, pretzel const
 // [AAA], [], [BAC].
 pretzel make_subpretzel(pretzel::const_iterator first, pretzel::const_iterator last);
 
+// Does all of the above in a single pass: reorders *pr as partition_twists()
+// would, and returns the disconnected sub-pretzels as views into *pr (see
+// pretzel.hpp) with the offsets that make_subpretzel() would subtract, rather
+// than as copies. The views are valid until *pr is modified. Sorting the twists
+// by the group of their strand number takes O(n + m) time for n twists on m
+// strands, regardless of the number of groups.
+scratch_vector<pretzel_view> split_pretzel_components(pretzel * pr);
+
 // Given a braid or pretzel, computes its strand permutations. Let v denote the
 // result. Then v.size() == number_of_strands(pr), and incoming strand i exits
 // as strand v[i -1] (the "- 1" is because our strands are 1-based).
-std::vector<std::size_t> strand_permutations(pretzel const & pr);
+index_list strand_permutations(pretzel_view pr);
 
 // Count the cycles in the given permutation. Permutations are 1-based.
-std::size_t count_permutation_cycles(std::vector<std::size_t> const & permutation);
+std::size_t count_permutation_cycles(index_list const & permutation);
+
+// The link components of a braid or pretzel, i.e. the cycles of its strand
+// permutation, all found by compute_link_components() in a single pass over
+// the twists, in time linear in the numbers of twists and strands.
+struct link_components
+{
+    // The strand permutation, as returned by strand_permutations().
+    index_list permutation;
+
+    // The number of components, as counted by count_permutation_cycles().
+    std::size_t count;
+
+    // The component (0, 1, ..., count - 1) to which each incoming strand
+    // belongs; components are numbered in the order of their lowest strands.
+    index_list strand_component;
+
+    // The components of the two strands that meet in each twist, the one at
+    // the twist's own strand number first. A twist is a self-crossing of a
+    // component if they are equal.
+    scratch_vector<std::pair<std::size_t, std::size_t>> twist_components;
+};
+
+link_components compute_link_components(pretzel_view pr);
 
 // Given a braid or pretzel, this function finds the homology generators:
 // Let h = compute_homology(pr). Then the crossings pr[i] and pr[h[i] - 1]
 // are adjacent, and h[i] = 0 means there is no adjacency.
-std::vector<std::size_t> compute_homology(pretzel const & pr);
+index_list compute_homology(pretzel_view pr);
 
 // Given a braid or pretzel, compute the link's Seifert matrix. The matrix is
 // pruned, i.e. zero rows/columns have already been removed. The Seifert matrix
 // is derived from the homology generators of "pr" that are obtained by calling
 // compute_homology() above.
-square_matrix<int> compute_seifert_matrix(pretzel const & pr);
+square_matrix<int> compute_seifert_matrix(pretzel_view pr);
+
+// The same Seifert matrix in sparse form, which is built directly and never
+// stored densely. Each row has at most five non-zero entries, and the matrix
+// (like the homology) is computed in time linear in the length of "pr".
+sparse_matrix<int> compute_sparse_seifert_matrix(pretzel_view pr);
+
+// Overloads of the above for compact pretzels (see compact_pretzel.hpp), which
+// only read their arrays of strand numbers.
+std::size_t number_of_strands(compact_pretzel const & cp);
+index_list missing_strands(compact_pretzel const & cp);
+index_list strand_permutations(compact_pretzel const & cp);
+index_list compute_homology(compact_pretzel const & cp);
 
 #endif
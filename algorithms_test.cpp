@@ -1,3 +1,5 @@
+#include <random>
+
 #include "algorithms.hpp"
 #include "pretzel.hpp"
 #include "testing.hpp"
@@ -14,13 +16,13 @@ void TestMissingStrands()
 {
     {
         pretzel pr = { {1, 1}, {2, -1}, {3, 3} };
-        std::vector<std::size_t> expected = { };
+        index_list expected = { };
         EXPECT_EQ(missing_strands(pr), expected);
     }
 
     {
         pretzel pr = { {6, 1}, {4, -1}, {3, 3} };
-        std::vector<std::size_t> expected = { 1, 2, 5 };
+        index_list expected = { 1, 2, 5 };
         EXPECT_EQ(missing_strands(pr), expected);
     }
 }
@@ -41,12 +43,12 @@ void TestPartitionTwists()
 
 void TestGroupPretzelComponents()
 {
-    using V = std::vector<std::pair<pretzel::const_iterator, pretzel::const_iterator>>;
+    using V = component_list;
 
     {
         // One group
         pretzel pr = { {1, 1}, {3, 1}, {2, 1} };
-        std::vector<std::size_t> missing = missing_strands(pr);
+        index_list missing = missing_strands(pr);
         partition_twists(missing, &pr);
 
         V groups = group_pretzel_components(missing, pr), expected({{pr.cbegin(), pr.cend()}});
@@ -56,7 +58,7 @@ void TestGroupPretzelComponents()
     {
         // Two groups: [(1, 1), (2, 1)] and [(4, 1)]
         pretzel pr = { {1, 1}, {4, 1}, {2, 1} };
-        std::vector<std::size_t> missing = missing_strands(pr);
+        index_list missing = missing_strands(pr);
         partition_twists(missing, &pr);
 
         auto it = pr.cbegin();
@@ -71,26 +73,157 @@ void TestMakeSubPretzel()
     EXPECT_EQ(make_subpretzel(pr.begin(), pr.end()), expected);
 }
 
+void TestSplitPretzelComponents()
+{
+    // "BEBDBF" has groups [], [BBB], [EDF] (strands 1 and 3 are missing), i.e.
+    // sub-pretzels [], [AAA], [BAC].
+    pretzel pr = { {2, 1}, {5, 1}, {2, 1}, {4, 1}, {2, 1}, {6, 1} };
+    auto views = split_pretzel_components(&pr);
+    EXPECT_EQ(pr, pretzel({ {2, 1}, {2, 1}, {2, 1}, {5, 1}, {4, 1}, {6, 1} }));
+    EXPECT_EQ(views.size(), 3u);
+    EXPECT_TRUE(views[0].empty());
+    EXPECT_EQ(views[1].to_pretzel(), pretzel({ {1, 1}, {1, 1}, {1, 1} }));
+    EXPECT_EQ(views[2].to_pretzel(), pretzel({ {2, 1}, {1, 1}, {3, 1} }));
+    EXPECT_EQ(views[2].source_begin(), pr.data() + 3);
+    EXPECT_EQ(views[2].offset(), 3u);
+    EXPECT_EQ(views[2][0], twist(2, 1));
+
+    // The same as the separate steps, and the algorithms see the views as the
+    // sub-pretzels.
+    std::mt19937 rng(3);
+    for (int trial = 0; trial != 200; ++trial)
+    {
+        pretzel q;
+        for (int i = 0, n = rng() % 20; i != n; ++i) { q.emplace_back(rng() % 12 + 1, rng() % 2 ? 1 : -3); }
+
+        pretzel expected = q;
+        index_list missing = missing_strands(expected);
+        partition_twists(missing, &expected);
+        component_list groups = group_pretzel_components(missing, expected);
+
+        views = split_pretzel_components(&q);
+        EXPECT_EQ(q, expected);
+        EXPECT_EQ(views.size(), groups.size());
+        for (std::size_t g = 0; g != views.size() && g != groups.size(); ++g)
+        {
+            pretzel sub = make_subpretzel(groups[g].first, groups[g].second);
+            EXPECT_EQ(views[g].to_pretzel(), sub);
+            EXPECT_EQ(number_of_strands(views[g]), number_of_strands(sub));
+            EXPECT_EQ(compute_link_components(views[g]).count, compute_link_components(sub).count);
+            EXPECT_EQ(compute_homology(views[g]), compute_homology(sub));
+
+            square_matrix<int> const sm = compute_seifert_matrix(views[g]), expected_sm = compute_seifert_matrix(sub);
+            EXPECT_EQ(sm.dim(), expected_sm.dim());
+            std::size_t mismatches = 0;
+            for (std::size_t i = 0; i != sm.dim() && i != expected_sm.dim(); ++i)
+                for (std::size_t j = 0; j != sm.dim() && j != expected_sm.dim(); ++j)
+                    if (sm(i, j) != expected_sm(i, j)) { ++mismatches; }
+            EXPECT_EQ(mismatches, 0u);
+        }
+    }
+
+    // Many groups take no longer than one.
+    pr.clear();
+    for (unsigned int i = 0; i != 200000; ++i) { pr.emplace_back(2 * (i % 50000) + 1, 1); }
+    views = split_pretzel_components(&pr);
+    EXPECT_EQ(views.size(), 50000u);
+    EXPECT_EQ(views.back().size(), 4u);
+    EXPECT_EQ(views.back().offset(), 99998u);
+}
+
 void TestStrandPermutations()
 {
     pretzel pr = { {1, 1}, {1, 1}, {1, 1} };
-    std::vector<std::size_t> expected = { 2, 1 };
+    index_list expected = { 2, 1 };
     EXPECT_EQ(strand_permutations(pr), expected);
 }
 
 void TestCountPermutationCycles()
 {
     {
-        std::vector<std::size_t> perm = { 2, 4, 3, 1 }; // Cycles: [2, 4, 1], [3]
+        index_list perm = { 2, 4, 3, 1 }; // Cycles: [2, 4, 1], [3]
         EXPECT_EQ(count_permutation_cycles(perm), 2u);
     }
 
     {
-        std::vector<std::size_t> perm = { 1 };          // Cycles: [1]
+        index_list perm = { 1 };          // Cycles: [1]
         EXPECT_EQ(count_permutation_cycles(perm), 1u);
     }
 }
 
+void TestLinkComponents()
+{
+    using P = std::pair<std::size_t, std::size_t>;
+
+    // Strands 1 and 2 cross twice, 3 and 4 once: three components.
+    pretzel pr = { {1, 1}, {1, -1}, {3, 1} };
+    link_components lc = compute_link_components(pr);
+    EXPECT_EQ(lc.permutation, strand_permutations(pr));
+    EXPECT_EQ(lc.count, 3u);
+    EXPECT_EQ(lc.strand_component, index_list({ 0, 1, 2, 2 }));
+    EXPECT_TRUE(lc.twist_components == scratch_vector<P>({ P(0, 1), P(1, 0), P(2, 2) }));
+
+    // The trefoil is a knot, and every twist is a self-crossing.
+    pr = { {1, 3} };
+    lc = compute_link_components(pr);
+    EXPECT_EQ(lc.count, 1u);
+    EXPECT_TRUE(lc.twist_components == scratch_vector<P>(1, P(0, 0)));
+
+    // The empty pretzel is the unknot.
+    lc = compute_link_components(pretzel());
+    EXPECT_EQ(lc.count, 1u);
+    EXPECT_TRUE(lc.twist_components.empty());
+
+    // The count agrees with the cycles of the permutation.
+    pr.clear();
+    for (unsigned int i = 0; i != 1000; ++i) { pr.emplace_back((i * 7919) % 199 + 1, 1); }
+    lc = compute_link_components(pr);
+    EXPECT_EQ(lc.count, count_permutation_cycles(strand_permutations(pr)));
+}
+
+void TestHomology()
+{
+    EXPECT_TRUE(compute_homology(pretzel()).empty());
+
+    // Each crossing is adjacent to the next one on the same strand.
+    pretzel pr = { {1, 1}, {2, 1}, {1, -1}, {3, 1}, {1, 1} };
+    EXPECT_EQ(compute_homology(pr), index_list({ 3, 0, 5, 0 }));
+}
+
+void TestSeifertMatrixLongBraid()
+{
+    // The braid "1 2 1 2 ..." of a million crossings: every crossing but the
+    // last two has homology, and the entries away from the end are the same
+    // as for a short braid.
+    std::size_t const n = 1000000;
+    pretzel pr;
+    for (std::size_t i = 0; i != n; ++i) { pr.emplace_back(i % 2 + 1, 1); }
+    sparse_matrix<int> const sm = compute_sparse_seifert_matrix(pr);
+    EXPECT_EQ(sm.rows(), n - 2);
+    EXPECT_TRUE(sm.nonzeros() < 4 * n);
+
+    pr.resize(8);
+    square_matrix<int> const small = compute_seifert_matrix(pr);
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i != 4; ++i)
+        for (std::size_t j = 0; j != 4; ++j)
+            if (sm(i, j) != small(i, j)) { ++mismatches; }
+    EXPECT_EQ(mismatches, 0u);
+    EXPECT_EQ(small(0, 0), -1);
+    EXPECT_EQ(small(0, 1), 1);
+    EXPECT_EQ(small(2, 0), 1);
+}
+
+void TestSeifertMatrixLargeTwists()
+{
+    // The self-linking number of a pair of maximal twists does not overflow.
+    int const max = 2147483647;
+    pretzel pr = { {1, max}, {1, max} };
+    square_matrix<int> sm = compute_seifert_matrix(pr);
+    EXPECT_EQ(sm.dim(), 1u);
+    EXPECT_EQ(sm(0, 0), -max);
+}
+
 void TestSimplify()
 {
     {
@@ -117,6 +250,89 @@ void TestSimplify()
     }
 }
 
+void TestCommuteNormalForm()
+{
+    // Twists move forward past commuting twists on higher strands, but never
+    // past twists on the same or adjacent strands.
+    pretzel pr = { {5, 1}, {3, 1}, {1, 1}, {5, 1}, {3, 1}, {1, 1} };
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_EQ(pr, pretzel({ {1, 1}, {1, 1}, {3, 1}, {3, 1}, {5, 1}, {5, 1} }));
+
+    pr = { {3, 1}, {1, 1}, {2, 1}, {4, 3}, {1, 1}, {3, 1}, {2, 1}, {4, 3} };
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_EQ(pr, pretzel({ {1, 1}, {3, 1}, {2, 1}, {1, 1}, {4, 3}, {3, 1}, {2, 1}, {4, 3} }));
+}
+
+void TestSimplifyLongBraid()
+{
+    // (ABCDE)^n (edcba)^n cancels completely, and a long braid with distant
+    // strands is sorted; both would take far too long if every step restarted
+    // from the front, or swapped one pair of twists at a time.
+    std::size_t const n = 20000;
+    pretzel pr;
+    for (std::size_t i = 0; i != 5 * n; ++i) { pr.emplace_back(i % 5 + 1, 1); }
+    for (std::size_t i = 5 * n; i-- != 0; ) { pr.emplace_back(i % 5 + 1, -1); }
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_TRUE(pr.empty());
+
+    // (CA)^m => A^m C^m, and no twist is trimmed.
+    std::size_t const m = 25000;
+    pr.clear();
+    for (std::size_t i = 0; i != m; ++i) { pr.emplace_back(3, 1); pr.emplace_back(1, 1); }
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_EQ(pr.size(), 2 * m);
+    EXPECT_EQ(pr[m - 1].first, 1u);
+    EXPECT_EQ(pr[m].first, 3u);
+
+    // A C (Ff)^k: the failed searches of A and C pass every pair, but only a
+    // cancellation of a twist at which a search stopped repeats it.
+    std::size_t const k = 40000;
+    pr = { {1, 1}, {3, 1} };
+    for (std::size_t i = 0; i != k; ++i) { pr.emplace_back(6, 1); pr.emplace_back(6, -1); }
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_TRUE(pr.empty());
+
+    // The staircases ABC... and ...CBA are trimmed one twist at a time.
+    std::size_t const s = 40000;
+    pr.clear();
+    for (unsigned int st = 1; st <= s; ++st) { pr.emplace_back(st, 1); }
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_TRUE(pr.empty());
+
+    pr.clear();
+    for (unsigned int st = s; st != 0; --st) { pr.emplace_back(st, 1); }
+    EXPECT_TRUE(simplify(&pr));
+    EXPECT_TRUE(pr.empty());
+}
+
+void TestSimplifyBudget()
+{
+    // A C5 E5 G5 ... a: the inverses cancel only if the search may examine
+    // all the twists in between; the rest is trimmed either way.
+    pretzel pr = { {1, 1} };
+    for (unsigned int st = 3; st != 23; st += 2) { pr.emplace_back(st, 5); }
+    pr.emplace_back(1, -1);
+
+    {
+        pretzel q = pr;
+        EXPECT_TRUE(simplify(&q));
+        EXPECT_TRUE(q.empty());
+    }
+
+    {
+        pretzel q = pr, expected = { {1, 1}, {1, -1} };
+        EXPECT_TRUE(simplify(&q, 5));
+        EXPECT_EQ(q, expected);
+    }
+
+    // The searches run to completion within the budget.
+    {
+        pretzel q = pr;
+        EXPECT_TRUE(simplify(&q, pr.size()));
+        EXPECT_TRUE(q.empty());
+    }
+}
+
 void TestNonSimplify()
 {
     {
@@ -139,8 +355,16 @@ int main()
     TestPartitionTwists();
     TestGroupPretzelComponents();
     TestMakeSubPretzel();
+    TestSplitPretzelComponents();
     TestStrandPermutations();
     TestCountPermutationCycles();
+    TestLinkComponents();
+    TestHomology();
+    TestSeifertMatrixLongBraid();
+    TestSeifertMatrixLargeTwists();
     TestSimplify();
+    TestCommuteNormalForm();
+    TestSimplifyLongBraid();
+    TestSimplifyBudget();
     TestNonSimplify();
 }
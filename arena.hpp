@@ -0,0 +1,241 @@
+// A monotonic arena for the scratch memory of one analysis:
+//
+//    arena scratch;
+//    {
+//        arena::scope use(scratch);            // make "scratch" current on this thread
+//        scratch_vector<int> v(100);            // allocated from "scratch"
+//    }
+//    scratch.reset();                           // all memory is available again
+//
+// Allocation from an arena is a pointer increment, and deallocation does
+// nothing; the memory is reclaimed all at once by reset(). A reset arena keeps
+// its memory (coalesced into a single block), so that processing a stream of
+// similar inputs allocates from the system only while the arena grows.
+//
+// The current arena is a per-thread setting that is selected by an
+// arena::scope for the scope's lifetime (scopes nest). arena_allocator<T>
+// allocates from the current arena, or from the free store if there is none;
+// it is stateless, so all containers of the same type are interchangeable.
+// Memory obtained from an arena must be released while that arena is still in
+// scope, and before the arena is reset. In particular, nothing that outlives
+// one analysis (such as a cache) may hold arena memory.
+//
+// Since an arena never reuses memory before it is reset, computations that
+// allocate and release temporaries over and over (such as the evaluation of
+// a large determinant at many points) should run under an arena::suspend,
+// which sends allocations to the free store until the end of its scope:
+//
+//    arena::suspend heap;                   // no arena allocations in this scope
+
+#ifndef H_ARENA
+#define H_ARENA
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "contract.hpp"
+
+class arena
+{
+    struct block
+    {
+        char * data;
+        std::size_t size;
+    };
+
+    // The innermost arena in scope, and whether it is suspended.
+    struct state
+    {
+        arena * top;
+        bool suspended;
+    };
+
+    static state & current_state()
+    {
+        static thread_local state s = { nullptr, false };
+        return s;
+    }
+
+public:
+    explicit arena(std::size_t initial_size = 64 * 1024)
+    : next_size_(initial_size < 64 ? 64 : initial_size), used_(0), prev_(nullptr), in_scope_(false)
+    { }
+
+    ~arena() { release(); }
+
+    arena(arena const &) = delete;
+    arena & operator=(arena const &) = delete;
+
+    class scope
+    {
+    public:
+        explicit scope(arena & a) : a_(a), suspended_(current_state().suspended)
+        {
+            CHECK(!a_.in_scope_, "Arena is already in scope.");
+            a_.in_scope_ = true;
+            a_.prev_ = current_state().top;
+            current_state() = { &a_, false };
+        }
+
+        ~scope()
+        {
+            current_state() = { a_.prev_, suspended_ };
+            a_.prev_ = nullptr;
+            a_.in_scope_ = false;
+        }
+
+        scope(scope const &) = delete;
+        scope & operator=(scope const &) = delete;
+
+    private:
+        arena & a_;
+        bool suspended_;
+    };
+
+    class suspend
+    {
+    public:
+        suspend() : suspended_(current_state().suspended) { current_state().suspended = true; }
+        ~suspend() { current_state().suspended = suspended_; }
+
+        suspend(suspend const &) = delete;
+        suspend & operator=(suspend const &) = delete;
+
+    private:
+        bool suspended_;
+    };
+
+    // The arena from which to allocate on this thread: that of the innermost
+    // scope, unless it is suspended. Null if there is none.
+    static arena * current()
+    {
+        state const & s = current_state();
+        return s.suspended ? nullptr : s.top;
+    }
+
+    // Returns n bytes aligned to "align", which must be a power of two no
+    // larger than alignof(std::max_align_t).
+    void * allocate(std::size_t n, std::size_t align)
+    {
+        if (!blocks_.empty())
+        {
+            block const & b = blocks_.back();
+            std::size_t const offset = (used_ + align - 1) & ~(align - 1);
+            if (offset <= b.size && n <= b.size - offset)
+            {
+                used_ = offset + n;
+                return b.data + offset;
+            }
+        }
+
+        // Start a new block, at least twice as large as the previous one.
+        while (next_size_ < n) { next_size_ *= 2; }
+        add_block(next_size_);
+        next_size_ *= 2;
+        used_ = n;
+        return blocks_.back().data;
+    }
+
+    // Whether p was allocated from this arena since the last reset.
+    bool owns(void const * p) const
+    {
+        std::less<void const *> less;
+        for (block const & b : blocks_)
+            if (!less(p, b.data) && less(p, b.data + b.size)) { return true; }
+        return false;
+    }
+
+    // The arena in scope on this thread (suspended or not) that owns p, or null.
+    static arena * owner(void const * p)
+    {
+        for (arena * a = current_state().top; a != nullptr; a = a->prev_)
+            if (a->owns(p)) { return a; }
+        return nullptr;
+    }
+
+    // Makes all memory available again. Requires that no allocations from this
+    // arena are still in use.
+    void reset()
+    {
+        if (blocks_.size() > 1)
+        {
+            std::size_t total = 0;
+            for (block const & b : blocks_) { total += b.size; }
+            release();
+            add_block(total);
+            next_size_ = 2 * total;
+        }
+        used_ = 0;
+    }
+
+    // The total size of the blocks held by the arena.
+    std::size_t capacity() const
+    {
+        std::size_t total = 0;
+        for (block const & b : blocks_) { total += b.size; }
+        return total;
+    }
+
+    // The number of blocks held by the arena.
+    std::size_t blocks() const { return blocks_.size(); }
+
+private:
+    void add_block(std::size_t n)
+    {
+        blocks_.reserve(blocks_.size() + 1);
+        blocks_.push_back({ static_cast<char *>(::operator new(n)), n });
+    }
+
+    void release()
+    {
+        for (block const & b : blocks_) { ::operator delete(b.data); }
+        blocks_.clear();
+    }
+
+    std::vector<block> blocks_;
+    std::size_t next_size_;
+    std::size_t used_;            // bytes used in the last block
+    arena * prev_;                // enclosing scope's arena while in scope
+    bool in_scope_;
+};
+
+// A minimal allocator that allocates from the current arena (see above).
+template <typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+
+    arena_allocator() = default;
+
+    template <typename U>
+    arena_allocator(arena_allocator<U> const &) { }
+
+    T * allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) { throw std::bad_alloc(); }
+
+        if (arena * a = arena::current()) { return static_cast<T *>(a->allocate(n * sizeof(T), alignof(T))); }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T * p, std::size_t)
+    {
+        if (arena::owner(p) == nullptr) { ::operator delete(p); }
+    }
+};
+
+template <typename T, typename U>
+bool operator==(arena_allocator<T> const &, arena_allocator<U> const &) { return true; }
+
+template <typename T, typename U>
+bool operator!=(arena_allocator<T> const &, arena_allocator<U> const &) { return false; }
+
+// A vector whose storage comes from the current arena.
+template <typename T>
+using scratch_vector = std::vector<T, arena_allocator<T>>;
+
+#endif
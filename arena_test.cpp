@@ -0,0 +1,109 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "arena.hpp"
+#include "matrix.hpp"
+#include "pretzel.hpp"
+#include "testing.hpp"
+
+void TestAllocate()
+{
+    arena scratch(1024);
+    {
+        arena::scope use(scratch);
+        EXPECT_TRUE(arena::current() == &scratch);
+
+        scratch_vector<int> v(10, 1);
+        EXPECT_TRUE(scratch.owns(v.data()));
+        EXPECT_TRUE(arena::owner(v.data()) == &scratch);
+
+        scratch_vector<double> w(3);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(w.data()) % alignof(double), 0u);
+
+        // Larger than the first block.
+        scratch_vector<char> big(5000);
+        EXPECT_TRUE(scratch.owns(big.data()));
+        EXPECT_EQ(scratch.blocks(), 2u);
+    }
+    EXPECT_TRUE(arena::current() == nullptr);
+
+    // Without an arena in scope, memory comes from the free store.
+    scratch_vector<int> v(10, 1);
+    EXPECT_FALSE(scratch.owns(v.data()));
+}
+
+void TestReset()
+{
+    arena scratch(256);
+    for (int round = 0; round != 3; ++round)
+    {
+        {
+            arena::scope use(scratch);
+            for (int i = 0; i != 20; ++i) { scratch_vector<long int> v(100, i); }
+        }
+
+        // After the first round, the coalesced block suffices.
+        EXPECT_EQ(scratch.blocks(), round == 0 ? 5u : 1u);
+        scratch.reset();
+        EXPECT_EQ(scratch.blocks(), 1u);
+    }
+}
+
+void TestNesting()
+{
+    arena outer, inner;
+
+    arena::scope use_outer(outer);
+    scratch_vector<int> kept(10);
+    {
+        arena::scope use_inner(inner);
+        EXPECT_TRUE(arena::current() == &inner);
+
+        scratch_vector<int> w(10);
+        EXPECT_TRUE(inner.owns(w.data()));
+
+        // Memory from the enclosing arena may be released in an inner scope.
+        kept = scratch_vector<int>(20);
+        EXPECT_TRUE(inner.owns(kept.data()));
+        kept.clear();
+        kept.shrink_to_fit();
+    }
+    EXPECT_TRUE(arena::current() == &outer);
+
+    {
+        arena::suspend heap;
+        EXPECT_TRUE(arena::current() == nullptr);
+
+        scratch_vector<int> c(10);
+        EXPECT_FALSE(outer.owns(c.data()));
+
+        {
+            arena::scope use_inner(inner);
+            EXPECT_TRUE(arena::current() == &inner);
+        }
+        EXPECT_TRUE(arena::current() == nullptr);
+    }
+    EXPECT_TRUE(arena::current() == &outer);
+}
+
+void TestContainers()
+{
+    arena scratch;
+    arena::scope use(scratch);
+
+    pretzel pr = { { 1, 1 }, { 2, -1 } };
+    EXPECT_TRUE(scratch.owns(pr.data()));
+
+    square_matrix<int> m(3);
+    m(0, 0) = m(1, 1) = m(2, 2) = 2;
+    EXPECT_TRUE(scratch.owns(&m(0, 0)));
+    EXPECT_EQ(m.determinant(), 8);
+}
+
+int main()
+{
+    TestAllocate();
+    TestReset();
+    TestNesting();
+    TestContainers();
+}
@@ -0,0 +1,259 @@
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+#include "bigint.hpp"
+#include "contract.hpp"
+
+bigint::operator double() const
+{
+    double result = 0;
+    for (auto it = magnitude_.rbegin(); it != magnitude_.rend(); ++it)
+    {
+        result = std::ldexp(result, 32) + *it;
+    }
+    return negative_ ? -result : result;
+}
+
+bigint & bigint::operator+=(bigint const & rhs)
+{
+    add(rhs, false);
+    return *this;
+}
+
+bigint & bigint::operator-=(bigint const & rhs)
+{
+    add(rhs, true);
+    return *this;
+}
+
+bigint & bigint::operator*=(bigint const & rhs)
+{
+    magnitude_ = multiply_magnitudes(magnitude_, rhs.magnitude_);
+    negative_ = !magnitude_.empty() && negative_ != rhs.negative_;
+    return *this;
+}
+
+bigint & bigint::operator/=(bigint const & rhs)
+{
+    CHECK(!rhs.magnitude_.empty(), "Division by zero!");
+
+    magnitude_ = divide_magnitudes(magnitude_, rhs.magnitude_);
+    negative_ = !magnitude_.empty() && negative_ != rhs.negative_;
+    return *this;
+}
+
+bigint bigint::operator-() const
+{
+    bigint result(*this);
+    result.negative_ = !magnitude_.empty() && !negative_;
+    return result;
+}
+
+void bigint::add(bigint const & rhs, bool negate)
+{
+    bool const rhs_negative = negate != rhs.negative_;
+
+    if (negative_ == rhs_negative)
+    {
+        add_magnitude(&magnitude_, rhs.magnitude_);
+    }
+    else if (compare_magnitudes(magnitude_, rhs.magnitude_) >= 0)
+    {
+        subtract_magnitude(&magnitude_, rhs.magnitude_);
+    }
+    else
+    {
+        magnitude m = rhs.magnitude_;
+        subtract_magnitude(&m, magnitude_);
+        magnitude_.swap(m);
+        negative_ = rhs_negative;
+    }
+
+    if (magnitude_.empty()) { negative_ = false; }
+}
+
+int bigint::compare(bigint const & a, bigint const & b)
+{
+    if (a.negative_ != b.negative_) { return a.negative_ ? -1 : 1; }
+
+    int const c = compare_magnitudes(a.magnitude_, b.magnitude_);
+    return a.negative_ ? -c : c;
+}
+
+int bigint::compare_magnitudes(magnitude const & a, magnitude const & b)
+{
+    if (a.size() != b.size()) { return a.size() < b.size() ? -1 : 1; }
+
+    for (std::size_t i = a.size(); i != 0; --i)
+    {
+        if (a[i - 1] != b[i - 1]) { return a[i - 1] < b[i - 1] ? -1 : 1; }
+    }
+    return 0;
+}
+
+void bigint::add_magnitude(magnitude * a, magnitude const & b)
+{
+    if (a->size() < b.size()) { a->resize(b.size(), 0); }
+
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i != a->size() && (carry != 0 || i < b.size()); ++i)
+    {
+        carry += (*a)[i];
+        if (i < b.size()) { carry += b[i]; }
+        (*a)[i] = static_cast<limb>(carry);
+        carry >>= 32;
+    }
+    if (carry != 0) { a->push_back(static_cast<limb>(carry)); }
+}
+
+void bigint::subtract_magnitude(magnitude * a, magnitude const & b)
+{
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i != a->size() && (borrow != 0 || i < b.size()); ++i)
+    {
+        std::int64_t d = static_cast<std::int64_t>((*a)[i]) - borrow - (i < b.size() ? b[i] : 0);
+        borrow = d < 0;
+        (*a)[i] = static_cast<limb>(d);
+    }
+    assert(borrow == 0);
+
+    while (!a->empty() && a->back() == 0) { a->pop_back(); }
+}
+
+bigint::magnitude bigint::multiply_magnitudes(magnitude const & a, magnitude const & b)
+{
+    if (a.empty() || b.empty()) { return magnitude(); }
+
+    magnitude result(a.size() + b.size(), 0);
+    for (std::size_t i = 0; i != a.size(); ++i)
+    {
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j != b.size(); ++j)
+        {
+            carry += static_cast<std::uint64_t>(a[i]) * b[j] + result[i + j];
+            result[i + j] = static_cast<limb>(carry);
+            carry >>= 32;
+        }
+        result[i + b.size()] = static_cast<limb>(carry);
+    }
+
+    while (!result.empty() && result.back() == 0) { result.pop_back(); }
+    return result;
+}
+
+bigint::limb bigint::divide_magnitude(magnitude * a, limb b)
+{
+    std::uint64_t rem = 0;
+    for (std::size_t i = a->size(); i != 0; --i)
+    {
+        std::uint64_t cur = (rem << 32) | (*a)[i - 1];
+        (*a)[i - 1] = static_cast<limb>(cur / b);
+        rem = cur % b;
+    }
+
+    while (!a->empty() && a->back() == 0) { a->pop_back(); }
+    return static_cast<limb>(rem);
+}
+
+bigint::magnitude bigint::divide_magnitudes(magnitude const & a, magnitude const & b)
+// Knuth's Algorithm D (TAOCP Vol. 2, 4.3.1), following the presentation in
+// Hacker's Delight, 9-2.
+{
+    if (compare_magnitudes(a, b) < 0) { return magnitude(); }
+
+    if (b.size() == 1)
+    {
+        magnitude q = a;
+        divide_magnitude(&q, b[0]);
+        return q;
+    }
+
+    std::size_t const m = a.size(), n = b.size();
+
+    // Normalize so that the top bit of the divisor is set.
+    int s = 0;
+    for (limb top = b.back(); (top & 0x80000000u) == 0; top <<= 1) { ++s; }
+
+    magnitude vn(n), un(m + 1);
+    for (std::size_t i = n - 1; i != 0; --i)
+        vn[i] = (b[i] << s) | (s == 0 ? 0 : b[i - 1] >> (32 - s));
+    vn[0] = b[0] << s;
+
+    un[m] = s == 0 ? 0 : a[m - 1] >> (32 - s);
+    for (std::size_t i = m - 1; i != 0; --i)
+        un[i] = (a[i] << s) | (s == 0 ? 0 : a[i - 1] >> (32 - s));
+    un[0] = a[0] << s;
+
+    std::uint64_t const base = std::uint64_t(1) << 32;
+    magnitude q(m - n + 1, 0);
+
+    for (std::size_t j = m - n + 1; j-- != 0; )
+    {
+        // Estimate the quotient digit and correct it to be at most one too large.
+        std::uint64_t num = (static_cast<std::uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+        std::uint64_t qhat = num / vn[n - 1], rhat = num % vn[n - 1];
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+        {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= base) { break; }
+        }
+
+        // Multiply and subtract.
+        std::int64_t borrow = 0, t;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            std::uint64_t p = qhat * vn[i];
+            t = static_cast<std::int64_t>(un[i + j]) - borrow - static_cast<std::int64_t>(p & 0xFFFFFFFFu);
+            un[i + j] = static_cast<limb>(t);
+            borrow = static_cast<std::int64_t>(p >> 32) - (t >> 32);
+        }
+        t = static_cast<std::int64_t>(un[j + n]) - borrow;
+        un[j + n] = static_cast<limb>(t);
+
+        q[j] = static_cast<limb>(qhat);
+
+        // If we subtracted too much, add back.
+        if (t < 0)
+        {
+            --q[j];
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                carry += static_cast<std::uint64_t>(un[i + j]) + vn[i];
+                un[i + j] = static_cast<limb>(carry);
+                carry >>= 32;
+            }
+            un[j + n] += static_cast<limb>(carry);
+        }
+    }
+
+    while (!q.empty() && q.back() == 0) { q.pop_back(); }
+    return q;
+}
+
+std::string to_string(bigint const & n)
+{
+    if (n.magnitude_.empty()) { return "0"; }
+
+    // Extract base 10^9 digits, least significant first.
+    bigint::magnitude m = n.magnitude_;
+    std::vector<bigint::limb> chunks;
+    while (!m.empty()) { chunks.push_back(bigint::divide_magnitude(&m, 1000000000u)); }
+
+    std::string result = n.negative_ ? "-" : "";
+    result += std::to_string(chunks.back());
+    for (std::size_t i = chunks.size() - 1; i != 0; --i)
+    {
+        std::string chunk = std::to_string(chunks[i - 1]);
+        result.append(9 - chunk.size(), '0');
+        result += chunk;
+    }
+    return result;
+}
+
+std::ostream & operator<<(std::ostream & os, bigint const & n)
+{
+    return os << to_string(n);
+}
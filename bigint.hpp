@@ -0,0 +1,112 @@
+// An arbitrary-precision signed integer type:
+//
+//    bigint a = 1;
+//    for (int i = 0; i != 100; ++i) { a *= 2; }
+//    std::cout << a << "\n";          // prints 2^100
+//
+// Supports the ring operations, truncating division and comparison, and can be
+// constructed from any built-in signed integral type. Since
+// std::numeric_limits<bigint> is exact and integral, matrices of bigints are
+// eliminated by fraction-free elimination (see matrix.hpp). The digits are
+// stored in a scratch_vector, i.e. in the current arena, if any (see arena.hpp).
+
+#ifndef H_BIGINT
+#define H_BIGINT
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "arena.hpp"
+
+class bigint
+{
+public:
+    bigint() : negative_(false) { }
+
+    template <typename I,
+              typename = typename std::enable_if<!std::is_class<I>::value &&
+                                                 std::numeric_limits<I>::is_integer &&
+                                                 std::numeric_limits<I>::is_signed>::type>
+    bigint(I n)
+    : negative_(n < 0)
+    {
+        // Peel off 16 bits at a time, which works for any signed type
+        // (including the most negative value) without overflow.
+        std::uint32_t limb = 0;
+        int shift = 0;
+        for (; n != 0; n /= 65536)
+        {
+            I r = n % 65536;
+            limb |= static_cast<std::uint32_t>(r < 0 ? -r : r) << shift;
+            if ((shift += 16) == 32) { magnitude_.push_back(limb); limb = 0; shift = 0; }
+        }
+        if (limb != 0) { magnitude_.push_back(limb); }
+    }
+
+    // The nearest double (up to rounding of the low limbs).
+    explicit operator double() const;
+
+    bigint & operator+=(bigint const & rhs);
+    bigint & operator-=(bigint const & rhs);
+    bigint & operator*=(bigint const & rhs);
+
+    // Truncating division (rounding towards zero). Requires that rhs be
+    // non-zero.
+    bigint & operator/=(bigint const & rhs);
+
+    bigint operator-() const;
+
+    friend bigint operator+(bigint a, bigint const & b) { return a += b; }
+    friend bigint operator-(bigint a, bigint const & b) { return a -= b; }
+    friend bigint operator*(bigint a, bigint const & b) { return a *= b; }
+    friend bigint operator/(bigint a, bigint const & b) { return a /= b; }
+
+    friend bool operator==(bigint const & a, bigint const & b)
+    {
+        return a.negative_ == b.negative_ && a.magnitude_ == b.magnitude_;
+    }
+    friend bool operator!=(bigint const & a, bigint const & b) { return !(a == b); }
+    friend bool operator< (bigint const & a, bigint const & b) { return compare(a, b) < 0; }
+    friend bool operator> (bigint const & a, bigint const & b) { return compare(a, b) > 0; }
+    friend bool operator<=(bigint const & a, bigint const & b) { return compare(a, b) <= 0; }
+    friend bool operator>=(bigint const & a, bigint const & b) { return compare(a, b) >= 0; }
+
+    friend std::string to_string(bigint const & n);
+
+private:
+    using limb = std::uint32_t;
+    using magnitude = scratch_vector<limb>;   // little endian, no leading zeros
+
+    static int compare(bigint const & a, bigint const & b);
+    static int compare_magnitudes(magnitude const & a, magnitude const & b);
+    static void add_magnitude(magnitude * a, magnitude const & b);
+    static void subtract_magnitude(magnitude * a, magnitude const & b);   // requires *a >= b
+    static magnitude multiply_magnitudes(magnitude const & a, magnitude const & b);
+    static magnitude divide_magnitudes(magnitude const & a, magnitude const & b);
+    static limb divide_magnitude(magnitude * a, limb b);                  // returns remainder
+
+    void add(bigint const & rhs, bool negate);
+
+    bool negative_;           // never true for zero
+    magnitude magnitude_;
+};
+
+std::string to_string(bigint const & n);
+std::ostream & operator<<(std::ostream & os, bigint const & n);
+
+namespace std
+{
+    template <> struct numeric_limits<bigint>
+    {
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_exact = true;
+        static constexpr bool is_integer = true;
+        static constexpr bool is_signed = true;
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include <limits>
+#include <string>
+
+#include "bigint.hpp"
+#include "testing.hpp"
+
+namespace
+{
+    bigint power(bigint x, int n)
+    {
+        bigint result = 1;
+        for (int i = 0; i != n; ++i) { result *= x; }
+        return result;
+    }
+}
+
+void TestConstruct()
+{
+    EXPECT_EQ(to_string(bigint()), "0");
+    EXPECT_EQ(to_string(bigint(0)), "0");
+    EXPECT_EQ(to_string(bigint(-17)), "-17");
+    EXPECT_EQ(to_string(bigint(std::numeric_limits<long int>::max())), "9223372036854775807");
+    EXPECT_EQ(to_string(bigint(std::numeric_limits<long int>::min())), "-9223372036854775808");
+
+    __extension__ typedef __int128 int128;
+    int128 big = static_cast<int128>(1) << 100;
+    EXPECT_EQ(to_string(bigint(big)), "1267650600228229401496703205376");
+    EXPECT_TRUE(bigint(big) == power(2, 100));
+}
+
+void TestArithmetic()
+{
+    bigint x = power(10, 30), y = power(7, 20);
+
+    EXPECT_EQ(to_string(x + y), "1000000000000079792266297612001");
+    EXPECT_EQ(to_string(y - x), "-999999999999920207733702387999");
+    EXPECT_EQ(to_string(x * -y), "-79792266297612001000000000000000000000000000000");
+    EXPECT_EQ(to_string(-x - -x), "0");
+    EXPECT_TRUE(x + -x == bigint());
+    EXPECT_EQ(static_cast<double>(x), 1e30);
+}
+
+void TestDivision()
+{
+    bigint x = power(10, 30), y = power(7, 20);
+
+    EXPECT_EQ(to_string(x / y), "12532542894196");
+    EXPECT_EQ(to_string(-x / y), "-12532542894196");
+    EXPECT_EQ(to_string(y / x), "0");
+    EXPECT_EQ(to_string(x / 1000000007), "999999993000000048999");
+    EXPECT_TRUE(x * y / y == x);
+    EXPECT_TRUE(power(3, 200) / power(3, 150) == power(3, 50));
+
+    // Multi-limb divisor: the remainder is non-negative and less than it.
+    bigint u = power(2, 96) - 1, v = power(2, 64) + power(2, 32) * 0x7FFFFFFF + 1;
+    EXPECT_TRUE(u / v * v <= u && u - u / v * v < v);
+}
+
+void TestCompare()
+{
+    EXPECT_TRUE(bigint(-5) < bigint(3));
+    EXPECT_TRUE(bigint(-5) < bigint(-3));
+    EXPECT_TRUE(power(2, 64) > power(2, 63));
+    EXPECT_TRUE(-power(2, 64) < -power(2, 63));
+    EXPECT_TRUE(bigint(4) >= 4);
+    EXPECT_TRUE(bigint(4) != -4);
+}
+
+int main()
+{
+    TestConstruct();
+    TestArithmetic();
+    TestDivision();
+    TestCompare();
+}
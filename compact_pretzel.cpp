@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "compact_pretzel.hpp"
+#include "contract.hpp"
+
+std::size_t const compact_pretzel::inline_capacity;
+unsigned int const compact_pretzel::max_strand;
+unsigned char const compact_pretzel::escape;
+
+compact_pretzel::compact_pretzel(pretzel const & pr)
+: compact_pretzel()
+{
+    reserve(pr.size());
+    for (twist const & tw : pr) { push_back(tw); }
+}
+
+compact_pretzel::compact_pretzel(compact_pretzel const & rhs)
+: compact_pretzel()
+{
+    reserve(rhs.size_);
+    std::copy(rhs.data_, rhs.data_ + rhs.size_, data_);
+    std::copy(rhs.counts(), rhs.counts() + rhs.size_, counts());
+    size_ = rhs.size_;
+    if (rhs.overflow_) { overflow_.reset(new overflow_table(*rhs.overflow_)); }
+}
+
+compact_pretzel::compact_pretzel(compact_pretzel && rhs) noexcept
+: compact_pretzel()
+{
+    swap(rhs);
+}
+
+void compact_pretzel::swap(compact_pretzel & rhs) noexcept
+{
+    // Inline data has to be copied; since both inline buffers have the same
+    // capacity, the layouts match.
+    bool const this_inline = data_ == inline_, rhs_inline = rhs.data_ == rhs.inline_;
+    std::swap_ranges(inline_, inline_ + storage_size(inline_capacity), rhs.inline_);
+    std::swap(data_, rhs.data_);
+    if (this_inline) { rhs.data_ = rhs.inline_; }
+    if (rhs_inline)  { data_ = inline_; }
+
+    std::swap(size_, rhs.size_);
+    std::swap(capacity_, rhs.capacity_);
+    std::swap(overflow_, rhs.overflow_);
+}
+
+int compact_pretzel::count(std::size_t i) const
+{
+    unsigned char const c = counts()[i];
+    if (c != escape) { return c < 0x80 ? int(c) : int(c) - 0x100; }
+
+    auto const it = std::lower_bound(overflow_->begin(), overflow_->end(), i,
+                                     [](std::pair<std::size_t, int> const & e, std::size_t j) { return e.first < j; });
+    return it->second;
+}
+
+void compact_pretzel::push_back(twist const & tw)
+{
+    CHECK(tw.first <= max_strand, "The strand number is too large for a compact pretzel.");
+
+    if (size_ == capacity_) { reserve(2 * capacity_); }
+
+    data_[size_] = strand_type(tw.first);
+    if (-127 <= tw.second && tw.second <= 127)
+    {
+        counts()[size_] = static_cast<unsigned char>(tw.second & 0xFF);
+    }
+    else
+    {
+        counts()[size_] = escape;
+        if (!overflow_) { overflow_.reset(new overflow_table); }
+        overflow_->emplace_back(size_, tw.second);
+    }
+    ++size_;
+}
+
+void compact_pretzel::reserve(std::size_t n)
+{
+    if (n <= capacity_) { return; }
+
+    CHECK(n <= std::numeric_limits<std::uint32_t>::max() - 1, "Too many twists for a compact pretzel.");
+
+    std::size_t const capacity = n + n % 2;
+    strand_type * data = new strand_type[storage_size(capacity)];
+    std::copy(data_, data_ + size_, data);
+    std::memcpy(data + capacity, counts(), size_);
+
+    if (data_ != inline_) { delete[] data_; }
+    data_ = data;
+    capacity_ = capacity;
+}
+
+std::size_t compact_pretzel::allocated_bytes() const
+{
+    std::size_t bytes = data_ == inline_ ? 0 : storage_size(capacity_) * sizeof(strand_type);
+    if (overflow_) { bytes += overflow_->capacity() * sizeof(overflow_table::value_type); }
+    return bytes;
+}
+
+pretzel compact_pretzel::to_pretzel() const
+{
+    pretzel pr;
+    pr.reserve(size_);
+    for (std::size_t i = 0; i != size_; ++i) { pr.push_back((*this)[i]); }
+    return pr;
+}
+
+bool operator==(compact_pretzel const & lhs, compact_pretzel const & rhs)
+{
+    if (lhs.size() != rhs.size()) { return false; }
+    for (std::size_t i = 0; i != lhs.size(); ++i)
+    {
+        if (lhs[i] != rhs[i]) { return false; }
+    }
+    return true;
+}
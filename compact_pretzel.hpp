@@ -0,0 +1,143 @@
+// A compact container for pretzels that are kept in memory in large numbers.
+//
+// A pretzel (see pretzel.hpp) takes eight bytes per twist and always has its
+// twists in a separately allocated array. A compact_pretzel stores the strand
+// numbers and the twisting counts in separate arrays ("structure of arrays"),
+// as 16-bit strand numbers and one-byte counts, i.e. three bytes per twist. The
+// rare counts that do not fit into eight bits are stored in a side table. Up
+// to inline_capacity twists are stored in the object itself, without a
+// separate allocation.
+//
+// The algorithms that only look at the strand numbers (see algorithms.hpp)
+// have overloads for compact pretzels that read the strand array alone; for
+// everything else, a compact pretzel is converted to and from a pretzel:
+//
+//    compact_pretzel cp(pr);                  // e.g. when storing a corpus
+//    index_list missing = missing_strands(cp);
+//    pretzel copy = cp.to_pretzel();          // for the other algorithms
+//
+// Compact pretzels are meant to outlive an analysis, so unlike pretzels they
+// always take their memory from the free store, never from an arena.
+
+#ifndef H_COMPACT_PRETZEL
+#define H_COMPACT_PRETZEL
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "pretzel.hpp"
+
+class compact_pretzel
+{
+public:
+    using strand_type = std::uint16_t;
+
+    static std::size_t const inline_capacity = 8;
+
+    // The largest strand number that can be stored.
+    static unsigned int const max_strand = 65535;
+
+    // Random access to the twists, by value.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = twist;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = twist;
+
+        const_iterator() : cp_(nullptr), i_(0) { }
+        const_iterator(compact_pretzel const * cp, std::size_t i) : cp_(cp), i_(i) { }
+
+        twist operator*() const { return (*cp_)[i_]; }
+        twist operator[](difference_type n) const { return (*cp_)[i_ + n]; }
+
+        const_iterator & operator++() { ++i_; return *this; }
+        const_iterator & operator--() { --i_; return *this; }
+        const_iterator operator++(int) { const_iterator r(*this); ++i_; return r; }
+        const_iterator operator--(int) { const_iterator r(*this); --i_; return r; }
+        const_iterator & operator+=(difference_type n) { i_ += n; return *this; }
+        const_iterator & operator-=(difference_type n) { i_ -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(cp_, i_ + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(cp_, i_ - n); }
+        difference_type operator-(const_iterator const & rhs) const { return difference_type(i_) - difference_type(rhs.i_); }
+
+        bool operator==(const_iterator const & rhs) const { return i_ == rhs.i_; }
+        bool operator!=(const_iterator const & rhs) const { return i_ != rhs.i_; }
+        bool operator<(const_iterator const & rhs) const { return i_ < rhs.i_; }
+        bool operator>(const_iterator const & rhs) const { return i_ > rhs.i_; }
+        bool operator<=(const_iterator const & rhs) const { return i_ <= rhs.i_; }
+        bool operator>=(const_iterator const & rhs) const { return i_ >= rhs.i_; }
+
+    private:
+        compact_pretzel const * cp_;
+        std::size_t i_;
+    };
+
+    compact_pretzel() : data_(inline_), size_(0), capacity_(inline_capacity) { }
+    explicit compact_pretzel(pretzel const & pr);
+
+    compact_pretzel(compact_pretzel const & rhs);
+    compact_pretzel(compact_pretzel && rhs) noexcept;
+    compact_pretzel & operator=(compact_pretzel rhs) noexcept { swap(rhs); return *this; }
+    ~compact_pretzel() { if (data_ != inline_) { delete[] data_; } }
+
+    void swap(compact_pretzel & rhs) noexcept;
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return capacity_; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    twist operator[](std::size_t i) const { return twist(strand(i), count(i)); }
+    unsigned int strand(std::size_t i) const { return data_[i]; }
+    int count(std::size_t i) const;
+
+    // The contiguous array of the size() strand numbers.
+    strand_type const * strands() const { return data_; }
+
+    // Requires that tw.first be at most max_strand.
+    void push_back(twist const & tw);
+
+    void reserve(std::size_t n);
+    void clear() { size_ = 0; overflow_.reset(); }
+
+    // The number of bytes used by the twists, including the side table and
+    // any unused capacity, but not the object itself.
+    std::size_t allocated_bytes() const;
+
+    pretzel to_pretzel() const;
+
+    friend bool operator==(compact_pretzel const & lhs, compact_pretzel const & rhs);
+
+private:
+    // The counts from -127 to 127 are stored as bytes in two's complement.
+    // The byte 0x80 stands for a count in the side table, which lists the
+    // indices and counts of those twists in increasing order of index.
+    static unsigned char const escape = 0x80;
+    using overflow_table = std::vector<std::pair<std::size_t, int>>;
+
+    // The data is an array of capacity_ strand numbers, followed by the
+    // capacity_ count bytes (so the capacity is always even).
+    unsigned char * counts() { return reinterpret_cast<unsigned char *>(data_ + capacity_); }
+    unsigned char const * counts() const { return reinterpret_cast<unsigned char const *>(data_ + capacity_); }
+
+    static std::size_t storage_size(std::size_t capacity) { return capacity + capacity / 2; }
+
+    strand_type * data_;
+    std::uint32_t size_;
+    std::uint32_t capacity_;
+    std::unique_ptr<overflow_table> overflow_;
+    strand_type inline_[inline_capacity + inline_capacity / 2];
+};
+
+inline bool operator!=(compact_pretzel const & lhs, compact_pretzel const & rhs) { return !(lhs == rhs); }
+
+#endif
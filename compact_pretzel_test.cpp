@@ -0,0 +1,95 @@
+#include <random>
+#include <utility>
+
+#include "algorithms.hpp"
+#include "compact_pretzel.hpp"
+#include "pretzel.hpp"
+#include "testing.hpp"
+
+void TestRoundTrip()
+{
+    pretzel pr = { {1, 1}, {3, -1}, {2, 127}, {2, -127}, {65535, 3} };
+    compact_pretzel cp(pr);
+    EXPECT_EQ(cp.size(), pr.size());
+    EXPECT_EQ(cp.to_pretzel(), pr);
+    EXPECT_EQ(cp[1], twist(3, -1));
+    EXPECT_EQ(cp.strand(4), 65535u);
+    EXPECT_EQ(cp.count(2), 127);
+
+    // Short pretzels are stored inline.
+    EXPECT_EQ(cp.allocated_bytes(), 0u);
+
+    pretzel copy(cp.begin(), cp.end());
+    EXPECT_EQ(copy, pr);
+
+    EXPECT_TRUE(compact_pretzel().empty());
+    EXPECT_TRUE(compact_pretzel().to_pretzel().empty());
+}
+
+void TestLargeCounts()
+{
+    // Counts outside [-127, 127] go to the side table.
+    pretzel pr = { {1, 128}, {2, 1}, {1, -128}, {3, 2147483647}, {2, -2147483647 - 1}, {1, -1} };
+    compact_pretzel cp(pr);
+    EXPECT_EQ(cp.to_pretzel(), pr);
+    EXPECT_EQ(cp.count(0), 128);
+    EXPECT_EQ(cp.count(2), -128);
+    EXPECT_EQ(cp.count(4), -2147483647 - 1);
+    EXPECT_TRUE(cp.allocated_bytes() != 0);
+}
+
+void TestGrowth()
+{
+    std::mt19937 rng(1);
+    pretzel pr;
+    compact_pretzel cp;
+    for (int i = 0; i != 10000; ++i)
+    {
+        int const count = i % 100 == 0 ? int(rng() % 1000) - 500 : int(rng() % 7) - 3;
+        pr.emplace_back(rng() % 300 + 1, count);
+        cp.push_back(pr.back());
+    }
+    EXPECT_EQ(cp.to_pretzel(), pr);
+
+    // Three bytes per twist (plus the side table), rather than eight.
+    EXPECT_TRUE(cp.allocated_bytes() < 4 * cp.capacity());
+    EXPECT_TRUE(compact_pretzel(pr).allocated_bytes() < 4 * pr.size());
+
+    // Copies, moves and swaps, between inline and allocated storage.
+    compact_pretzel small(pretzel({ {2, 1}, {1, -301} }));
+    compact_pretzel copy(cp), moved(std::move(copy));
+    EXPECT_TRUE(moved == cp);
+    moved.swap(small);
+    EXPECT_TRUE(small == cp);
+    EXPECT_EQ(moved.to_pretzel(), pretzel({ {2, 1}, {1, -301} }));
+    moved = small;
+    EXPECT_TRUE(moved == cp);
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_TRUE(moved != cp);
+}
+
+void TestAlgorithms()
+{
+    // The overloads for compact pretzels agree with those for pretzels.
+    std::mt19937 rng(2);
+    for (int trial = 0; trial != 100; ++trial)
+    {
+        pretzel pr;
+        for (int i = 0, n = rng() % 50; i != n; ++i) { pr.emplace_back(rng() % 9 + 1, rng() % 2 ? 1 : -3); }
+        compact_pretzel cp(pr);
+
+        EXPECT_EQ(number_of_strands(cp), number_of_strands(pr));
+        EXPECT_EQ(missing_strands(cp), missing_strands(pr));
+        EXPECT_EQ(strand_permutations(cp), strand_permutations(pr));
+        EXPECT_EQ(compute_homology(cp), compute_homology(pr));
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestLargeCounts();
+    TestGrowth();
+    TestAlgorithms();
+}
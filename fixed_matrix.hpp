@@ -0,0 +1,98 @@
+// A square matrix of fixed, compile-time dimension: fixed_square_matrix<T, N>
+//
+//    fixed_square_matrix<long int, 3> m;     // zero-initialized
+//    m(0, 0) = m(1, 1) = m(2, 2) = 2;
+//    long int d = m.determinant();           // d == 8
+//
+// The entries are stored in an std::array, so that no allocation takes place,
+// and all loop bounds of the elimination are compile-time constants, which
+// the compiler can unroll. This is meant for the many small Seifert matrices
+// (see max_fixed_dim); larger ones use square_matrix<T>.
+//
+// A fixed_square_matrix is a matrix expression (see matrix.hpp), so it can be
+// assigned from and take part in expressions of matrices of the same size:
+//
+//    fixed_square_matrix<long int, 3> work;
+//    work.assign(m + m.transposed() * -2L);
+
+#ifndef H_FIXED_MATRIX
+#define H_FIXED_MATRIX
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#include "contract.hpp"
+#include "matrix.hpp"
+
+// The largest dimension for which fixed-size matrices are instantiated by the
+// dimension dispatch (see alexander.cpp).
+std::size_t const max_fixed_dim = 16;
+
+template <typename T, std::size_t N>
+class fixed_square_matrix : public matrix_expression<fixed_square_matrix<T, N>>
+{
+public:
+    using value_type = T;
+
+    fixed_square_matrix() : data_() { }
+
+    // Evaluates a matrix expression of dimension N.
+    template <typename E>
+    explicit fixed_square_matrix(matrix_expression<E> const & e)
+    {
+        assign(e);
+    }
+
+    // Evaluates a matrix expression of dimension N into this matrix. The
+    // expression must not refer to this matrix.
+    template <typename E>
+    fixed_square_matrix & assign(matrix_expression<E> const & e)
+    {
+        E const & x = e.self();
+        CHECK(x.rows() == N && x.cols() == N, "Trying to assign a matrix of the wrong size!");
+
+        for (std::size_t i = 0; i != N; ++i)
+            for (std::size_t j = 0; j != N; ++j)
+                data_[i * N + j] = T(x.entry(i, j));
+        return *this;
+    }
+
+    static std::size_t dim() { return N; }
+    static std::size_t rows() { return N; }
+    static std::size_t cols() { return N; }
+
+    T const & operator()(std::size_t i, std::size_t j) const { assert(i < N && j < N); return data_[i * N + j]; }
+    T       & operator()(std::size_t i, std::size_t j)       { assert(i < N && j < N); return data_[i * N + j]; }
+
+    // Unchecked access, for matrix expressions.
+    T const & entry(std::size_t i, std::size_t j) const { return data_[i * N + j]; }
+
+    matrix_detail::transposed_expression<fixed_square_matrix> transposed() const
+    {
+        return matrix_detail::transposed_expression<fixed_square_matrix>(*this);
+    }
+
+    // As for square_matrix<T>.
+    T determinant() const
+    {
+        fixed_square_matrix m(*this);
+        return m.determinant_in_place();
+    }
+
+    T determinant_in_place()
+    {
+        return matrix_detail::eliminate_determinant(data_.data(), N);
+    }
+
+private:
+    std::array<T, N * N> data_;
+};
+
+namespace matrix_detail
+{
+    template <typename T, std::size_t N>
+    struct expression_storage<fixed_square_matrix<T, N>> { using type = fixed_square_matrix<T, N> const &; };
+}
+
+#endif
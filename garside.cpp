@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+#include "contract.hpp"
+#include "garside.hpp"
+
+namespace
+{
+    // A permutation braid together with its inverse permutation: pos[i] is the
+    // final position of the strand that starts in position i, and at[j] is the
+    // starting position of the strand that ends in position j. The braid s_i
+    // (in the numbering of pretzels) crosses the positions i - 1 and i.
+    struct simple_braid
+    {
+        index_list pos, at;
+
+        static simple_braid identity(std::size_t m)
+        {
+            simple_braid r;
+            for (std::size_t i = 0; i != m; ++i) { r.pos.push_back(i); }
+            r.at = r.pos;
+            return r;
+        }
+
+        static simple_braid delta(std::size_t m)
+        {
+            simple_braid r;
+            for (std::size_t i = 0; i != m; ++i) { r.pos.push_back(m - 1 - i); }
+            r.at = r.pos;
+            return r;
+        }
+
+        // The crossing of the positions i and i + 1.
+        static simple_braid crossing(std::size_t m, std::size_t i)
+        {
+            simple_braid r = identity(m);
+            std::swap(r.pos[i], r.pos[i + 1]);
+            r.at = r.pos;
+            return r;
+        }
+
+        bool is_identity() const
+        {
+            for (std::size_t i = 0; i != pos.size(); ++i) { if (pos[i] != i) { return false; } }
+            return true;
+        }
+
+        bool is_delta() const
+        {
+            for (std::size_t i = 0; i != pos.size(); ++i) { if (pos[i] != pos.size() - 1 - i) { return false; } }
+            return true;
+        }
+
+        // D^-1 A D, in which the crossings of the positions i and i + 1 become
+        // crossings of the positions m - 2 - i and m - 1 - i.
+        simple_braid flipped() const
+        {
+            std::size_t const m = pos.size();
+            simple_braid r;
+            for (std::size_t i = 0; i != m; ++i) { r.pos.push_back(m - 1 - pos[m - 1 - i]); }
+            for (std::size_t i = 0; i != m; ++i) { r.at.push_back(m - 1 - at[m - 1 - i]); }
+            return r;
+        }
+
+        // The complement A^-1 D, i.e. the permutation braid B with A B = D:
+        // it crosses exactly the pairs of strands that A does not.
+        simple_braid complement() const
+        {
+            std::size_t const m = pos.size();
+            simple_braid r;
+            for (std::size_t i = 0; i != m; ++i) { r.pos.push_back(m - 1 - at[i]); }
+            for (std::size_t j = 0; j != m; ++j) { r.at.push_back(pos[m - 1 - j]); }
+            return r;
+        }
+    };
+
+    // Moves crossings from the front of b to the end of a for as long as
+    // possible, so that afterwards (a, b) is left-weighted; returns whether
+    // anything was moved. A crossing of the positions i and i + 1 can be moved
+    // if the strands in these positions at the start of b cross in b, and the
+    // strands in these positions at the end of a do not cross in a. Moving it
+    // only affects that condition for the neighbouring positions, so we step
+    // back by one after each move.
+    bool make_left_weighted(simple_braid * a, simple_braid * b)
+    {
+        bool changed = false;
+        for (std::size_t i = 0; i + 1 < a->pos.size(); )
+        {
+            if (a->at[i] > a->at[i + 1] || b->pos[i] < b->pos[i + 1]) { ++i; continue; }
+
+            std::swap(a->at[i], a->at[i + 1]);
+            a->pos[a->at[i]] = i;
+            a->pos[a->at[i + 1]] = i + 1;
+
+            std::swap(b->pos[i], b->pos[i + 1]);
+            b->at[b->pos[i]] = i;
+            b->at[b->pos[i + 1]] = i + 1;
+
+            changed = true;
+            if (i != 0) { --i; }
+        }
+        return changed;
+    }
+
+    // A product D^k A_1 ... A_r in left normal form, to which permutation
+    // braids and powers of D can be appended. Since A D = D (D^-1 A D), a
+    // power of D is moved to the front by flipping all the factors; we only
+    // record whether they are flipped, and flip new factors to match.
+    class normal_form_builder
+    {
+    public:
+        explicit normal_form_builder(std::size_t m) : m_(m), power_(0), flipped_(false) { }
+
+        // Appending a factor only changes the factors from the last one back
+        // to the first one that is already left-weighted with its successor.
+        // Factors that become D can then only be at the front, and those that
+        // become trivial only at the end.
+        void append(simple_braid const & x)
+        {
+            factors_.push_back(flipped_ ? x.flipped() : x);
+            for (std::size_t t = factors_.size() - 1; t != 0 && make_left_weighted(&factors_[t - 1], &factors_[t]); --t) { }
+
+            while (!factors_.empty() && factors_.front().is_delta())  { factors_.pop_front(); ++power_; }
+            while (!factors_.empty() && factors_.back().is_identity()) { factors_.pop_back(); }
+        }
+
+        void append_delta()         { ++power_; flipped_ = !flipped_; }
+        void append_inverse_delta() { --power_; flipped_ = !flipped_; }
+
+        // The crossing s_i^sign of the positions i and i + 1; the inverse is
+        // s_i^-1 = (s_i^-1 D) D^-1.
+        void append_crossing(std::size_t i, int sign)
+        {
+            simple_braid const c = simple_braid::crossing(m_, i);
+            if (sign > 0) { append(c); return; }
+            append(c.complement());
+            append_inverse_delta();
+        }
+
+        long int power() const { return power_; }
+        std::size_t size() const { return factors_.size(); }
+        simple_braid factor(std::size_t t) const { return flipped_ ? factors_[t].flipped() : factors_[t]; }
+
+    private:
+        std::size_t m_;
+        long int power_;
+        bool flipped_;
+        std::deque<simple_braid> factors_;
+    };
+
+    normal_form_builder build(pretzel const & braid, std::size_t m)
+    {
+        normal_form_builder b(m);
+        for (twist const & tw : braid) { b.append_crossing(tw.first - 1, tw.second); }
+        return b;
+    }
+
+    // Appends a word for the permutation braid x to *out: each time, the
+    // lowest pair of adjacent strands that are still to cross crosses.
+    void spell(simple_braid const & x, pretzel * out)
+    {
+        index_list target(x.pos);
+        for (std::size_t i = 0; i + 1 < target.size(); )
+        {
+            if (target[i] < target[i + 1]) { ++i; continue; }
+
+            std::swap(target[i], target[i + 1]);
+            out->emplace_back(i + 1, 1);
+            if (i != 0) { --i; }
+        }
+    }
+
+    // Appends the word of the positive braid b (which must have a non-negative
+    // power of D) to *out, factor by factor.
+    void spell(normal_form_builder const & b, std::size_t m, pretzel * out)
+    {
+        std::size_t const delta_start = out->size();
+        if (b.power() > 0) { spell(simple_braid::delta(m), out); }
+        std::size_t const delta_length = out->size() - delta_start;
+        for (long int k = 1; k < b.power(); ++k)
+        {
+            for (std::size_t i = 0; i != delta_length; ++i) { out->push_back((*out)[delta_start + i]); }
+        }
+
+        for (std::size_t t = 0; t != b.size(); ++t) { spell(b.factor(t), out); }
+    }
+}
+
+bool is_braid_word(pretzel_view pr)
+{
+    return std::all_of(pr.begin(), pr.end(), [](twist tw) { return tw.second == 1 || tw.second == -1; });
+}
+
+left_normal_form compute_left_normal_form(pretzel const & braid, std::size_t strands)
+{
+    CHECK(is_braid_word(braid), "The pretzel is not a braid word.");
+    CHECK(strands >= number_of_strands(braid), "Too few strands for the braid word.");
+
+    normal_form_builder const b = build(braid, strands);
+
+    left_normal_form result;
+    result.delta_power = b.power();
+    for (std::size_t t = 0; t != b.size(); ++t) { result.factors.push_back(b.factor(t).pos); }
+    return result;
+}
+
+bool canonicalize_braid(pretzel * p)
+{
+    CHECK(p != nullptr, "The pretzel must not be null.");
+    CHECK(is_braid_word(*p), "The pretzel is not a braid word.");
+
+    std::size_t const m = number_of_strands(*p);
+    normal_form_builder const b = build(*p, m);
+
+    // With D^-k A_1 ... A_r and k > 0, let j = min(k, r). Since D^-1 A = (A^-1 D)^-1
+    // = c(A)^-1, and D^-1 x^-1 = (x D)^-1 = (D f(x))^-1 where f is the flip,
+    // we have
+    //
+    //    D^-k A_1 ... A_r = (c(A_j) f(c(A_(j-1))) ... f^(j-1)(c(A_1)) D^(k-j))^-1 A_(j+1) ... A_r,
+    //
+    // which is N^-1 P with N and P without common left divisor.
+    normal_form_builder negative(m), positive(m);
+    if (b.power() >= 0)
+    {
+        positive = b;
+    }
+    else
+    {
+        std::size_t const k = -b.power();
+        std::size_t const j = std::min(k, b.size());
+
+        for (std::size_t t = j; t-- != 0; )
+        {
+            simple_braid c = b.factor(t).complement();
+            if ((j - 1 - t) % 2 != 0) { c = c.flipped(); }
+            negative.append(c);
+        }
+        for (std::size_t e = j; e != k; ++e) { negative.append_delta(); }
+
+        for (std::size_t t = j; t != b.size(); ++t) { positive.append(b.factor(t)); }
+    }
+
+    pretzel word;
+    spell(negative, m, &word);
+    std::reverse(word.begin(), word.end());
+    for (twist & tw : word) { tw.second = -tw.second; }
+    spell(positive, m, &word);
+
+    if (word == *p) { return false; }
+    p->swap(word);
+    return true;
+}
@@ -0,0 +1,69 @@
+// Canonical forms of braids.
+//
+// A braid word, i.e. a pretzel all of whose twists are +/-1, represents an
+// element of the braid group on m = number_of_strands() strands, in which the
+// twist (i, +1) is the generator s_i that crosses strands i and i + 1. Many
+// words represent the same braid, and simplify() (see algorithms.hpp) is a set
+// of rewriting heuristics that need not arrive at the same word for all of
+// them. The Garside normal form is canonical: every braid can be written
+// uniquely as
+//
+//    D^k A_1 ... A_r,
+//
+// where D is the half twist (in which every pair of strands crosses once), k
+// is an integer, each A_i is a permutation braid (a positive braid in which
+// every pair of strands crosses at most once) other than 1 and D, and each
+// pair A_i A_(i+1) is left-weighted, i.e. no crossing of A_(i+1) can be moved
+// into A_i. See e.g. Epstein et al., "Word processing in groups", Chapter 9,
+// and Elrifai and Morton, "Algorithms for positive braids" (1994).
+//
+// A permutation braid is determined by its permutation of the strands, so we
+// represent it by that. Multiplying two of them, or moving crossings from one
+// to another, takes time linear in the number of strands plus the number of
+// crossings moved.
+
+#ifndef H_GARSIDE
+#define H_GARSIDE
+
+#include "algorithms.hpp"
+#include "arena.hpp"
+#include "pretzel.hpp"
+
+// A permutation braid on m strands, given by the final position of the strand
+// that starts in position i (counting from zero) for i = 0, ..., m - 1.
+using permutation_braid = index_list;
+
+// The left normal form D^delta_power factors[0] ... factors[r - 1].
+struct left_normal_form
+{
+    long int delta_power;
+    scratch_vector<permutation_braid> factors;
+};
+
+inline bool operator==(left_normal_form const & lhs, left_normal_form const & rhs)
+{
+    return lhs.delta_power == rhs.delta_power && lhs.factors == rhs.factors;
+}
+
+// Returns whether every twist of the pretzel is a braid twist, (i, +/-1).
+bool is_braid_word(pretzel_view pr);
+
+// Computes the left normal form of the braid word "braid" on "strands" strands,
+// which must be at least number_of_strands(braid). Takes O(n r m) time in the
+// worst case for a word of n twists whose normal form has r factors; typically
+// much less, since each twist usually changes only the last few factors.
+left_normal_form compute_left_normal_form(pretzel const & braid, std::size_t strands);
+
+// Replaces the braid word *p by the canonical word of its braid, and returns
+// whether that changed *p. The canonical word is N^-1 P, where N and P are the
+// positive braids without common left divisor such that the braid is N^-1 P
+// (this is Thurston's symmetric form of the normal form above), and each of N
+// and P is spelled out factor by factor from its left normal form. Two braid
+// words therefore have the same canonical word if and only if they represent
+// the same braid, regardless of how many strands they mention. A positive
+// braid's canonical word is positive, and a negative braid's is negative.
+//
+// Requires is_braid_word(*p).
+bool canonicalize_braid(pretzel * p);
+
+#endif
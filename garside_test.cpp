@@ -0,0 +1,121 @@
+#include <random>
+
+#include "garside.hpp"
+#include "pretzel.hpp"
+#include "testing.hpp"
+
+void TestIsBraidWord()
+{
+    EXPECT_TRUE(is_braid_word(pretzel()));
+    EXPECT_TRUE(is_braid_word(pretzel({ {1, 1}, {3, -1} })));
+    EXPECT_FALSE(is_braid_word(pretzel({ {1, 1}, {2, 3} })));
+}
+
+void TestLeftNormalForm()
+{
+    using F = scratch_vector<permutation_braid>;
+
+    // The half twist on three strands, either way round.
+    left_normal_form f = compute_left_normal_form({ {1, 1}, {2, 1}, {1, 1} }, 3);
+    EXPECT_EQ(f.delta_power, 1);
+    EXPECT_TRUE(f.factors.empty());
+    EXPECT_TRUE(compute_left_normal_form({ {2, 1}, {1, 1}, {2, 1} }, 3) == f);
+
+    // s_1 and s_1^-1 = D^-1 s_1 s_2.
+    f = compute_left_normal_form({ {1, 1} }, 3);
+    EXPECT_EQ(f.delta_power, 0);
+    EXPECT_TRUE(f.factors == F({ { 1, 0, 2 } }));
+
+    f = compute_left_normal_form({ {1, -1} }, 3);
+    EXPECT_EQ(f.delta_power, -1);
+    EXPECT_TRUE(f.factors == F({ { 2, 0, 1 } }));
+
+    // s_1 s_2 s_2 s_1 has two factors, s_1 s_2 and s_2 s_1.
+    f = compute_left_normal_form({ {1, 1}, {2, 1}, {2, 1}, {1, 1} }, 3);
+    EXPECT_EQ(f.delta_power, 0);
+    EXPECT_TRUE(f.factors == F({ { 2, 0, 1 }, { 1, 2, 0 } }));
+
+    // Cancellations leave nothing.
+    f = compute_left_normal_form({ {1, 1}, {3, 1}, {3, -1}, {1, -1} }, 5);
+    EXPECT_EQ(f.delta_power, 0);
+    EXPECT_TRUE(f.factors.empty());
+}
+
+void TestCanonicalBraid()
+{
+    // "BAB" => "ABA"
+    pretzel pr = { {2, 1}, {1, 1}, {2, 1} };
+    EXPECT_TRUE(canonicalize_braid(&pr));
+    EXPECT_EQ(pr, pretzel({ {1, 1}, {2, 1}, {1, 1} }));
+    EXPECT_FALSE(canonicalize_braid(&pr));
+
+    // "aCcA" => ""
+    pr = { {1, -1}, {3, 1}, {3, -1}, {1, 1} };
+    EXPECT_TRUE(canonicalize_braid(&pr));
+    EXPECT_TRUE(pr.empty());
+
+    // "Ab" => "baBA" = (AB)^-1 BA, with the negative part first.
+    pr = { {1, 1}, {2, -1} };
+    EXPECT_TRUE(canonicalize_braid(&pr));
+    EXPECT_EQ(pr, pretzel({ {2, -1}, {1, -1}, {2, 1}, {1, 1} }));
+
+    // Negative words stay negative: "cba" is already canonical.
+    pr = { {3, -1}, {2, -1}, {1, -1} };
+    EXPECT_FALSE(canonicalize_braid(&pr));
+}
+
+void TestCanonicalBraidInvariance()
+{
+    // Words that differ by braid relations, by inverse pairs (also on strands
+    // that the other word does not mention) have the same canonical word, and
+    // that word represents the same braid.
+    std::mt19937 rng(1);
+    std::size_t mismatches = 0, changed = 0;
+    for (int trial = 0; trial != 2000; ++trial)
+    {
+        unsigned int const strands = rng() % 6 + 1;
+        pretzel pr;
+        for (int i = 0, n = rng() % 30; i != n; ++i) { pr.emplace_back(rng() % strands + 1, rng() % 2 ? 1 : -1); }
+
+        pretzel other = pr;
+        for (int k = 0; k != 20; ++k)
+        {
+            std::size_t const i = rng() % (other.size() + 1);
+            if (k % 2 == 0)
+            {
+                unsigned int const st = rng() % (strands + 2) + 1;
+                int const sign = rng() % 2 ? 1 : -1;
+                other.insert(other.begin() + i, { twist(st, sign), twist(st, -sign) });
+            }
+            else if (i + 2 < other.size() && other[i] == other[i + 2] && other[i].second == other[i + 1].second &&
+                     (other[i].first + 1 == other[i + 1].first || other[i + 1].first + 1 == other[i].first))
+            {
+                twist const x = other[i], y = other[i + 1];
+                other[i] = y;
+                other[i + 1] = x;
+                other[i + 2] = y;
+            }
+            else if (i + 1 < other.size() && (other[i].first > other[i + 1].first + 1 || other[i + 1].first > other[i].first + 1))
+            {
+                std::swap(other[i], other[i + 1]);
+            }
+        }
+
+        std::size_t const m = number_of_strands(other);
+        pretzel canonical = pr;
+        canonicalize_braid(&canonical);
+        canonicalize_braid(&other);
+        if (canonical != other) { ++mismatches; }
+        if (!(compute_left_normal_form(canonical, m) == compute_left_normal_form(pr, m))) { ++changed; }
+    }
+    EXPECT_EQ(mismatches, 0u);
+    EXPECT_EQ(changed, 0u);
+}
+
+int main()
+{
+    TestIsBraidWord();
+    TestLeftNormalForm();
+    TestCanonicalBraid();
+    TestCanonicalBraidInvariance();
+}
@@ -0,0 +1,239 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "algorithms.hpp"
+#include "contract.hpp"
+#include "jones.hpp"
+
+namespace
+{
+    __extension__ typedef __int128 int128;
+
+    // A Temperley-Lieb diagram on m strands, given by the partner of each of
+    // its 2m points: the top points are 0, ..., m - 1 and the bottom points
+    // are m, ..., 2m - 1.
+    using tl_diagram = std::vector<unsigned char>;
+
+    // Replaces the diagram D by D e_i (i.e. e_i attached below D) and returns
+    // whether that closes a loop, in which case D e_i = d D.
+    bool append_cap_cup(tl_diagram & dg, std::size_t m, std::size_t i)
+    {
+        std::size_t const b = m + i, c = m + i + 1;
+        if (dg[b] == c) { return true; }
+
+        std::size_t const x = dg[b], y = dg[c];
+        dg[x] = static_cast<unsigned char>(y);
+        dg[y] = static_cast<unsigned char>(x);
+        dg[b] = static_cast<unsigned char>(c);
+        dg[c] = static_cast<unsigned char>(b);
+        return false;
+    }
+
+    // The number of loops of the closure of D, which joins top point j to
+    // bottom point m + j.
+    std::size_t closure_loops(tl_diagram const & dg, std::size_t m)
+    {
+        std::vector<bool> seen(2 * m, false);
+        std::size_t loops = 0;
+        for (std::size_t s = 0; s != 2 * m; ++s)
+        {
+            if (seen[s]) { continue; }
+
+            ++loops;
+            std::size_t p = s;
+            do
+            {
+                std::size_t const q = dg[p];
+                seen[p] = seen[q] = true;
+                p = q < m ? q + m : q - m;
+            } while (p != s);
+        }
+        return loops;
+    }
+
+    // The diagrams of TL_m, numbered in order of discovery from the identity
+    // (number 0), and the action of e_1, ..., e_(m-1) on them.
+    struct tl_table
+    {
+        std::size_t generators;                 // m - 1
+        std::vector<std::uint32_t> product;     // D e_i at [D * generators + i]
+        std::vector<bool> closes_loop;          // whether D e_i = d D
+        std::vector<std::size_t> loops;         // loops(D)
+    };
+
+    tl_table make_tl_table(std::size_t m)
+    {
+        tl_table tl;
+        tl.generators = m - 1;
+
+        tl_diagram id(2 * m);
+        for (std::size_t j = 0; j != m; ++j)
+        {
+            id[j] = static_cast<unsigned char>(m + j);
+            id[m + j] = static_cast<unsigned char>(j);
+        }
+
+        // Every diagram is a product of the e_i.
+        std::vector<tl_diagram> diagrams(1, id);
+        std::map<tl_diagram, std::uint32_t> index;
+        index.emplace(id, 0);
+
+        for (std::size_t d = 0; d != diagrams.size(); ++d)
+        {
+            tl.loops.push_back(closure_loops(diagrams[d], m));
+
+            for (std::size_t i = 0; i != tl.generators; ++i)
+            {
+                tl_diagram dg = diagrams[d];
+                bool const loop = append_cap_cup(dg, m, i);
+
+                std::uint32_t const next = static_cast<std::uint32_t>(diagrams.size());
+                std::uint32_t const k = index.emplace(dg, next).first->second;
+                if (k == next) { diagrams.push_back(dg); }
+
+                tl.product.push_back(k);
+                tl.closes_loop.push_back(loop);
+            }
+        }
+
+        return tl;
+    }
+
+    // Returns an upper bound for log2 of the sum of the absolute values of
+    // the coefficients of the bracket. Each twist (i, k) multiplies the sum
+    // for all diagrams by at most |k| + 2 (|k| for c_k, and 2 for d A^-k), and
+    // closing up multiplies it by at most |d|^(m - 1), i.e. 2^(m - 1).
+    double coefficient_bits(pretzel_view pr, std::size_t m)
+    {
+        double bits = m - 1;
+        for (twist const tw : pr) { bits += std::log2(std::abs(static_cast<double>(tw.second)) + 2); }
+        return bits;
+    }
+
+    template <typename T>
+    jones_polynomial compute(pretzel_view pr, std::size_t m)
+    {
+        tl_table const tl = make_tl_table(m);
+        std::size_t const n = tl.loops.size();
+
+        // The coefficient of diagram D is the Laurent polynomial with the
+        // coefficients cur[D * width + j] of A^(lowest + j). Initially, the
+        // identity has coefficient 1.
+        long int lowest = 0;
+        std::size_t width = 1;
+        std::vector<T> cur(n, T(0)), next;
+        cur[0] = T(1);
+        long int writhe = 0;
+
+        for (twist const tw : pr)
+        {
+            std::size_t const i = tw.first - 1;
+            long int const k = tw.second, a = std::labs(k), sign = k > 0 ? 1 : -1;
+            writhe += k;
+
+            // The exponents of c_k are sign * (2 - a + 4 j) for 0 <= j < a,
+            // with alternating signs, and those of d A^-k are -k +/- 2. None
+            // exceeds the margin in absolute value.
+            long int const margin = 3 * a + 2;
+            std::size_t const next_width = width + 2 * margin;
+            next.assign(n * next_width, T(0));
+
+            for (std::size_t d = 0; d != n; ++d)
+            {
+                T const * from = &cur[d * width];
+                T * to = &next[d * next_width + margin];
+                T * to_product = &next[tl.product[d * tl.generators + i] * next_width + margin];
+                bool const loop = tl.closes_loop[d * tl.generators + i];
+
+                for (long int c = 0; c != static_cast<long int>(width); ++c)
+                {
+                    T const & v = from[c];
+                    if (v == T(0)) { continue; }
+
+                    for (long int j = 0; j != a; ++j)
+                    {
+                        if (j % 2 == 0) { to[c + sign * (2 - a + 4 * j)] += v; }
+                        else            { to[c + sign * (2 - a + 4 * j)] -= v; }
+                    }
+
+                    if (loop) { to[c - k + 2] -= v; to[c - k - 2] -= v; }
+                    else      { to_product[c - k] += v;                 }
+                }
+            }
+
+            // Trim the columns that are zero for all diagrams.
+            std::size_t first = next_width, last = 0;
+            for (std::size_t d = 0; d != n; ++d)
+            {
+                for (std::size_t c = 0; c != next_width; ++c)
+                {
+                    if (next[d * next_width + c] == T(0)) { continue; }
+                    if (c < first)     { first = c;    }
+                    if (c + 1 > last)  { last = c + 1; }
+                }
+            }
+            CHECK(first < last, "The bracket of a braid cannot vanish.");
+
+            width = last - first;
+            lowest += static_cast<long int>(first) - margin;
+            cur.assign(n * width, T(0));
+            for (std::size_t d = 0; d != n; ++d)
+                for (std::size_t c = 0; c != width; ++c) { cur[d * width + c] = next[d * next_width + first + c]; }
+        }
+
+        // Close up: <L> has the coefficients bracket[j] of A^(lowest - spread + j),
+        // where d^l = (-1)^l sum_j binomial(l, j) A^(2 l - 4 j).
+        long int const spread = 2 * static_cast<long int>(m - 1);
+        std::vector<T> bracket(width + 2 * spread, T(0));
+        for (std::size_t d = 0; d != n; ++d)
+        {
+            long int const l = static_cast<long int>(tl.loops[d]) - 1;
+
+            long int binomial = 1;
+            for (long int j = 0; j <= l; binomial = binomial * (l - j) / (j + 1), ++j)
+            {
+                T const factor = T((l % 2 ? -1 : 1) * binomial);
+                for (std::size_t c = 0; c != width; ++c)
+                {
+                    T const & v = cur[d * width + c];
+                    if (!(v == T(0))) { bracket[c + spread + 2 * l - 4 * j] += factor * v; }
+                }
+            }
+        }
+
+        // V(t) = (-1)^w A^(-3 w) <L>, and A^e = t^(-e / 4) = (t^(1/2))^(-e / 2).
+        // So the coefficients of increasing powers of t^(1/2) are those of
+        // decreasing even powers of A.
+        std::size_t first = 0, last = bracket.size();
+        while (first != last && bracket[first] == T(0)) { ++first; }
+        while (first != last && bracket[last - 1] == T(0)) { --last; }
+        CHECK(first != last, "The bracket of a braid cannot vanish.");
+
+        long int const highest = lowest - spread + static_cast<long int>(last - 1) - 3 * writhe;
+        CHECK(highest % 2 == 0 && (last - first) % 2 == 1, "The bracket has exponents of the wrong parity.");
+
+        jones_polynomial result;
+        result.lowest = -highest / 2;
+        for (std::size_t j = 0; j != (last - first + 1) / 2; ++j)
+        {
+            T const & v = bracket[last - 1 - 2 * j];
+            result.coefficients.push_back(bigint(writhe % 2 ? -v : v));
+        }
+        return result;
+    }
+}
+
+jones_polynomial compute_jones_polynomial(pretzel_view pr)
+{
+    std::size_t const m = number_of_strands(pr);
+    CHECK(m <= max_jones_strands, "Too many strands for the Jones polynomial.");
+
+    double const bits = coefficient_bits(pr, m) + 1;
+
+    if (bits < 62)  { return compute<long int>(pr, m); }
+    if (bits < 126) { return compute<int128>(pr, m); }
+    return compute<bigint>(pr, m);
+}
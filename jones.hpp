@@ -0,0 +1,65 @@
+// Computation of the Jones polynomial of a link by a transfer matrix.
+//
+// Kauffman's bracket replaces each crossing by a combination of its two
+// smoothings. Read from top to bottom, a pretzel on m strands is a product of
+// such tangles, so its bracket lives in the Temperley-Lieb algebra TL_m, which
+// is spanned by the C(m) (the m-th Catalan number) planar diagrams that join
+// 2m points without crossings, with loop value d = -A^2 - A^-2. For the braid
+// generator, i.e. the twist (i, +1),
+//
+//    <(i, +1)> = A 1 + A^-1 e_i,    <(i, -1)> = A^-1 1 + A e_i,
+//
+// where 1 is the identity and e_i joins strands i and i + 1 by a cap and a cup.
+// A general twist (i, k) (see pretzel.hpp) is the 90-degree rotation of k such
+// crossings, and rotation exchanges 1 and e_i, so (for k > 0)
+//
+//    <(i, k)> = c_k 1 + A^-k e_i,   c_k = (A^(3 k) + A^-k) / (A^2 + A^-2),
+//
+// and c_k is a Laurent polynomial with k terms; a negative k is the mirror
+// image, with A and A^-1 exchanged. We carry the coefficient of every diagram
+// through the twists one at a time (the "transfer matrix"), close the diagrams
+// up, and normalise:
+//
+//    <L> = sum over diagrams D of coeff(D) d^(loops(D) - 1),
+//    V(t) = (-A^3)^-w <L>,  with A = t^(-1/4),
+//
+// where loops(D) is the number of loops of the closure of D, and the writhe w
+// is the sum of the twist counts. This takes O(|k| C(m) s) operations per
+// twist, where s is the span of the coefficients, so the cost is linear in the
+// number of crossings for a fixed number of strands and a fixed span, rather
+// than exponential, like the sum over all 2^n states of the crossings.
+
+#ifndef H_JONES
+#define H_JONES
+
+#include <cstddef>
+
+#include "arena.hpp"
+#include "bigint.hpp"
+#include "pretzel.hpp"
+
+// The Jones polynomial of a link with an odd number of components is a Laurent
+// polynomial in t, and one with an even number of components is t^(1/2) times
+// one. We store it as a Laurent polynomial in t^(1/2).
+struct jones_polynomial
+{
+    // coefficients[i] is the coefficient of t^((lowest + i) / 2).
+    long int lowest;
+    scratch_vector<bigint> coefficients;
+};
+
+inline bool operator==(jones_polynomial const & lhs, jones_polynomial const & rhs)
+{
+    return lhs.lowest == rhs.lowest && lhs.coefficients == rhs.coefficients;
+}
+
+// The number of diagrams grows like 4^m, so we only handle up to this many
+// strands (C(12) = 208012).
+std::size_t const max_jones_strands = 12;
+
+// Computes the Jones polynomial of the pretzel. Requires that
+// number_of_strands(pr) be at most max_jones_strands. The arithmetic is exact,
+// in the narrowest integer type that a bound on the coefficients permits.
+jones_polynomial compute_jones_polynomial(pretzel_view pr);
+
+#endif
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "algorithms.hpp"
+#include "jones.hpp"
+#include "pretzel.hpp"
+#include "signature.hpp"
+#include "testing.hpp"
+
+namespace
+{
+    jones_polynomial jones_of(std::string const & s)
+    {
+        pretzel pr;
+        parse_string_as_pretzel(s, &pr);
+        return compute_jones_polynomial(pr);
+    }
+
+    jones_polynomial make_jones(long int lowest, std::initializer_list<int> coeffs)
+    {
+        jones_polynomial jp;
+        jp.lowest = lowest;
+        for (int c : coeffs) { jp.coefficients.push_back(c); }
+        return jp;
+    }
+
+    // V evaluated at t^(1/2) = i, as real and imaginary parts.
+    std::pair<bigint, bigint> value_at_minus_one(jones_polynomial const & jp)
+    {
+        bigint re, im;
+        for (std::size_t j = 0; j != jp.coefficients.size(); ++j)
+        {
+            switch (((jp.lowest + long(j)) % 4 + 4) % 4)
+            {
+                case 0: re += jp.coefficients[j]; break;
+                case 1: im += jp.coefficients[j]; break;
+                case 2: re -= jp.coefficients[j]; break;
+                case 3: im -= jp.coefficients[j]; break;
+            }
+        }
+        return std::make_pair(re, im);
+    }
+
+    bigint value_at_one(jones_polynomial const & jp)
+    {
+        bigint sum;
+        for (bigint const & c : jp.coefficients) { sum += c; }
+        return sum;
+    }
+}
+
+void TestSmallLinks()
+{
+    // Unknots.
+    EXPECT_TRUE(jones_of("") == make_jones(0, {1}));
+    EXPECT_TRUE(jones_of("A") == make_jones(0, {1}));
+    EXPECT_TRUE(jones_of("A3B5") == make_jones(0, {1}));
+
+    // Right- and left-handed trefoil, t + t^3 - t^4 and its mirror image.
+    EXPECT_TRUE(jones_of("AAA") == make_jones(2, {1, 0, 0, 0, 1, 0, -1}));
+    EXPECT_TRUE(jones_of("aaa") == make_jones(-8, {-1, 0, 1, 0, 0, 0, 1}));
+
+    // Figure eight knot, t^-2 - t^-1 + 1 - t + t^2.
+    EXPECT_TRUE(jones_of("AbAb") == make_jones(-4, {1, 0, -1, 0, 1, 0, -1, 0, 1}));
+
+    // Hopf link, -t^(1/2) - t^(5/2), and the two-component unlink.
+    EXPECT_TRUE(jones_of("AA") == make_jones(1, {-1, 0, 0, 0, -1}));
+    EXPECT_TRUE(jones_of("AC") == make_jones(-1, {-1, 0, -1}));
+}
+
+void TestTwists()
+{
+    // A twist (i, k) is a band with k half twists, not k crossings of a braid.
+    EXPECT_TRUE(jones_of("A3bA3b") == jones_of("bA3bA3"));
+    EXPECT_TRUE(jones_of("A-3") == jones_of("a3"));
+}
+
+void TestAgainstSeifert()
+{
+    // |V(-1)| is the determinant, and V(1) = (-2)^(components - 1).
+    std::mt19937 rng(1);
+    int const counts[] = { 1, -1, 3, -3, 5 };
+    for (int trial = 0; trial != 200; ++trial)
+    {
+        std::size_t const strands = rng() % 4 + 2;
+        pretzel pr;
+        for (std::size_t i = 1; i != strands; ++i) { pr.emplace_back(i, counts[rng() % 5]); }
+        for (int i = 0, n = rng() % 8; i != n; ++i) { pr.emplace_back(rng() % (strands - 1) + 1, counts[rng() % 5]); }
+        std::shuffle(pr.begin(), pr.end(), rng);
+
+        jones_polynomial const jp = compute_jones_polynomial(pr);
+        signature_result const sr = compute_signature(compute_seifert_matrix(pr));
+
+        std::pair<bigint, bigint> const at_minus_one = value_at_minus_one(jp);
+        bigint const re = at_minus_one.first < bigint(0) ? -at_minus_one.first : at_minus_one.first;
+        bigint const im = at_minus_one.second < bigint(0) ? -at_minus_one.second : at_minus_one.second;
+        EXPECT_EQ(re + im, sr.determinant);
+        EXPECT_TRUE(re == bigint(0) || im == bigint(0));
+
+        bigint expected = 1;
+        for (std::size_t c = 1; c != compute_link_components(pr).count; ++c) { expected *= -2; }
+        EXPECT_EQ(value_at_one(jp), expected);
+    }
+}
+
+void TestWide()
+{
+    // Long braids need 128-bit and arbitrary-precision coefficients.
+    std::mt19937 rng(2);
+    pretzel pr;
+    for (int i = 0; i != 150; ++i) { pr.emplace_back(rng() % 4 + 1, rng() % 2 ? 1 : -1); }
+
+    for (std::size_t n : { 40, 70, 150 })
+    {
+        pretzel prefix(pr.begin(), pr.begin() + n);
+        jones_polynomial const jp = compute_jones_polynomial(prefix);
+        signature_result const sr = compute_signature(compute_seifert_matrix(prefix));
+
+        std::pair<bigint, bigint> const at_minus_one = value_at_minus_one(jp);
+        bigint const v = at_minus_one.first + at_minus_one.second;
+        EXPECT_EQ(v < bigint(0) ? -v : v, sr.determinant);
+    }
+}
+
+int main()
+{
+    TestSmallLinks();
+    TestTwists();
+    TestAgainstSeifert();
+    TestWide();
+}
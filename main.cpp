@@ -1,68 +1,37 @@
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
-#include <numeric>
 #include <string>
+#include <thread>
 
+#include "alexander.hpp"
 #include "algorithms.hpp"
+#include "arena.hpp"
+#include "garside.hpp"
+#include "jones.hpp"
 #include "matrix_format.hpp"
+#include "parallel.hpp"
 #include "polynomial_format.hpp"
 #include "pretzel.hpp"
-
-// Compute an Alexander polynomial from a Seifert matrix. Returns the list of
-// coefficients, starting at degree zero.
-std::vector<long int> alexander_poly(square_matrix<int> const & sm)
-// We compute the coefficients of the Alexander polynomial by evaluating it on
-// d + 1 points, where d == sm.dim() is its degree. Solving for the coefficients
-// can be achieved by augmenting a Vandermonde matrix of d + 1 points with a
-// column of the values at those points and performing Gauss-Jordan elimination
-// on the augmented matrix.
-//
-// Note that even though all the input values are integers, we have to perform
-// the matrix elimination with floating point numbers and round the result back
-// to the nearest integer.
-{
-    // Step 1: Set up the Vandermonde matrix (at points 0, 1, ..., d).
-    std::vector<double> points(sm.dim() + 1);
-    std::iota(points.begin(), points.end(), 0);
-    matrix<double> augmented_vandermonde = vandermonde<double>(sm.dim() + 2, points);
-
-    // Step 2: Fill in the result p(t) = det(M - t M*) at those points.
-    std::size_t last_col = augmented_vandermonde.cols() - 1;
-    square_matrix<double> am(sm); // cast to double
-    for (std::size_t i = 0; i != augmented_vandermonde.rows(); ++i)
-    {
-        augmented_vandermonde(i, last_col) = (am + am.transpose() * (-points[i])).determinant();
-    }
-
-    // Step 3: Solve the linear system by Gauss-Jordan elimination.
-    matrix<double> solution = augmented_vandermonde.gauss_jordan();
-
-    // Step 4: Obtain the resulting polynomial coefficients by rounding.
-    std::vector<long int> coeffs;
-    coeffs.reserve(sm.dim() + 1);
-    for (std::size_t i = 0; i != sm.dim() + 1; ++i)
-    {
-        std::size_t const ri = sm.dim() - i;
-        coeffs.push_back(std::lround(solution(ri, last_col)));
-    }
-
-    // Step 5: Profit.
-    return coeffs;
-}
+#include "signature.hpp"
 
 // Compute and print analysis of a pretzel "pr". Typically we preprocess a
 // given pretzel and analyse it component by component, but it is equally
 // possible to analyse a complete, multi-component pretzel. The genus is
 // additive and the Seifert matrix is block-additive under disjoint unions.
-void analyse_one(pretzel const & pr, char const * pre = "")
+void analyse_one(pretzel_view pr, alexander_engine engine, bool do_signature, bool do_jones,
+                 char const * pre = "")
 {
-    // Seifert matrix.
-    square_matrix<int> sm = compute_seifert_matrix(pr);
+    // Seifert matrix (kept sparse; only printing and the dense engines
+    // expand it).
+    sparse_matrix<int> sm = compute_sparse_seifert_matrix(pr);
 
     // Number of connected components of the link.
-    std::size_t components = count_permutation_cycles(strand_permutations(pr));
+    std::size_t components = compute_link_components(pr).count;
 
     // Number of connected components of the Seifert surface.
     std::size_t k = missing_strands(pr).size() + 1;
@@ -85,8 +54,8 @@ void analyse_one(pretzel const & pr, char const * pre = "")
     //
     // TODO(tkoeppe): Move this code into algorithms?
 
-    assert((k + sm.dim() - components) % 2 == 0);
-    std::size_t genus = (k + sm.dim() - components) / 2;
+    assert((k + sm.rows() - components) % 2 == 0);
+    std::size_t genus = (k + sm.rows() - components) / 2;
 
     std::cout << pre << "The pretzel is a ";
     if (components == 1) { std::cout << "knot"; }
@@ -103,22 +72,67 @@ void analyse_one(pretzel const & pr, char const * pre = "")
     }
     else
     {
-        std::vector<long int> ap_coeffs = alexander_poly(sm);
+        // The Burau engine needs the braid word; otherwise it falls back to
+        // the Seifert matrix.
+        alexander_polynomial ap_coeffs = engine == alexander_engine::burau && is_braid_word(pr)
+                                             ? alexander_poly_burau(pr)
+                                             : alexander_poly(sm, engine);
         std::cout << pre << "Alexander polynomial: p(t) = "
                   << polynomial_to_string("t", ap_coeffs.begin(), ap_coeffs.end())
                   << "\n";
     }
+
+    if (do_signature)
+    {
+        // A disconnected Seifert surface can be made connected by adding k - 1
+        // tubes, each of which adds a zero row and column to M + M*; so the
+        // signature is the same, but the nullity grows and the determinant of
+        // a split link is zero.
+        signature_result sr = compute_signature(sm);
+        if (k > 1) { sr.nullity += k - 1; sr.determinant = 0; }
+
+        std::cout << pre << "Signature: " << sr.signature << ", nullity: " << sr.nullity
+                  << ", determinant: " << sr.determinant << "\n";
+    }
+
+    if (do_jones && number_of_strands(pr) > max_jones_strands)
+    {
+        std::cout << pre << "Not computing Jones polynomial because the pretzel has more than "
+                  << max_jones_strands << " strands.\n";
+    }
+    else if (do_jones)
+    {
+        jones_polynomial jp = compute_jones_polynomial(pr);
+        std::cout << pre << "Jones polynomial: V(t) = "
+                  << laurent_polynomial_to_string("t", jp.lowest, 2, jp.coefficients.begin(), jp.coefficients.end())
+                  << "\n";
+    }
 }
 
-void analyse_pretzel(pretzel pr, bool do_simplify)
+void analyse_pretzel(pretzel pr, bool do_canonicalize, bool do_simplify, std::size_t budget,
+                     alexander_engine engine, bool do_signature, bool do_jones)
 {
-    bool all_simplified = do_simplify && simplify(&pr);
+    if (do_canonicalize && is_braid_word(pr))
+    {
+        // The canonical word does not mention strands beyond the last one that
+        // the braid moves, and a pretzel has no way to keep them, so their
+        // split unknots are lost (like with simplification).
+        std::size_t const strands = number_of_strands(pr);
+        canonicalize_braid(&pr);
+        std::cout << "Canonical braid word: " << pr << '\n';
+
+        std::size_t const dropped = strands - std::min(strands, number_of_strands(pr));
+        if (dropped != 0)
+        {
+            std::cout << "The canonical word omits " << dropped << " unused strand(s); "
+                         "their split unknots are not analysed.\n";
+        }
+    }
 
-    std::vector<std::size_t> missing = missing_strands(pr);
-    partition_twists(missing, &pr);
+    bool all_simplified = do_simplify && simplify(&pr, budget);
 
-    // Disjoint connected components of the pretzel.
-    auto groups = group_pretzel_components(missing, pr);
+    // Disjoint connected components of the pretzel, as views into it.
+    auto groups = split_pretzel_components(&pr);
 
     char const * indent = "";
 
@@ -140,39 +154,97 @@ void analyse_pretzel(pretzel pr, bool do_simplify)
         std::cout << '\n';
     }
 
-    for (auto const & g : groups)
+    for (pretzel_view const & g : groups)
     {
-        auto spr = make_subpretzel(g.first, g.second);
+        // Only simplification needs a copy of the component.
+        pretzel spr;
+        if (do_simplify) { spr = g.to_pretzel(); }
 
-        bool sub_simplified = do_simplify && simplify(&spr);
+        bool sub_simplified = do_simplify && simplify(&spr, budget);
 
         std::cout << indent << "Pretzel" << (groups.size() > 1 ? " component" : "") << ": ";
 
-        print_range(std::cout, g.first, g.second);
+        print_range(std::cout, g.source_begin(), g.source_end());
         if (sub_simplified) { std::cout << " Simplified: " << spr; }
         std::cout << '\n';
 
-        analyse_one(spr, indent);
+        analyse_one(do_simplify ? pretzel_view(spr) : g, engine, do_signature, do_jones, indent);
         std::cout << '\n';
     }
 }
 
 int main(int argc, char * argv[])
 {
-    bool do_simplify = argc == 2 && std::strcmp(argv[1], "-s") == 0;
+    bool do_canonicalize = false;
+    bool do_simplify = false;
+    bool do_signature = false;
+    bool do_jones = false;
+    alexander_engine engine = alexander_engine::vandermonde;
+    unsigned long int threads = 1;
+    unsigned long int budget = default_search_budget;
+
+    // More threads than a few per hardware thread would only cost memory (and
+    // may not even be possible to create).
+    unsigned long int const max_threads = 4 * std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (int i = 1; i != argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-c") == 0) { do_canonicalize = true; continue; }
+        if (std::strcmp(argv[i], "-s") == 0) { do_simplify = true; continue; }
+        if (std::strcmp(argv[i], "-d") == 0) { do_signature = true; continue; }
+        if (std::strcmp(argv[i], "-v") == 0) { do_jones = true; continue; }
+
+        if (std::strcmp(argv[i], "-a") == 0 && i + 1 != argc && parse_alexander_engine(argv[i + 1], &engine))
+        {
+            ++i;
+            continue;
+        }
+
+        char * end;
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 != argc &&
+            std::isdigit(static_cast<unsigned char>(*argv[i + 1])) &&
+            (threads = std::strtoul(argv[i + 1], &end, 10), *end == '\0') &&
+            threads != 0 && threads <= max_threads)
+        {
+            ++i;
+            continue;
+        }
+
+        if (std::strcmp(argv[i], "-b") == 0 && i + 1 != argc &&
+            std::isdigit(static_cast<unsigned char>(*argv[i + 1])) &&
+            (errno = 0, budget = std::strtoul(argv[i + 1], &end, 10), *end == '\0') &&
+            errno != ERANGE)
+        {
+            ++i;
+            continue;
+        }
+
+        std::cerr << "Usage: " << argv[0] << " [-c] [-s [-b budget]] [-d] [-v] [-a vandermonde|exact|modular|hessenberg|fft|sparse|burau] [-j threads]\n";
+        return 1;
+    }
 
-    pretzel pr;
+    // The evaluations of the Alexander polynomial use this many threads.
+    set_parallelism(threads);
+
+    // All the memory of one analysis comes from this arena, which is reset
+    // between inputs, so that once it is large enough, processing further
+    // inputs does not allocate.
+    arena scratch;
 
     for (std::string line;
-         std::cerr << "Enter braid or pretzel (send EOF to quit): " && std::getline(std::cin, line); )
+         std::cerr << "Enter braid or pretzel (send EOF to quit): " && std::getline(std::cin, line);
+         scratch.reset())
     {
+        arena::scope use(scratch);
+        pretzel pr;
+
         if (!parse_string_as_pretzel(line, &pr))
         {
             std::cerr << "Failed to parse input ('" << line << "') as pretzel; skipping.\n";
             continue;
         }
 
-        analyse_pretzel(std::move(pr), do_simplify);
+        analyse_pretzel(std::move(pr), do_canonicalize, do_simplify, budget, engine, do_signature, do_jones);
     }
 
     std::cerr << "Goodbye.\n";
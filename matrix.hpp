@@ -3,11 +3,25 @@
 //    - A matrix class template: matrix<T>
 //    - A special square matrix version: square_matrix<T>
 //    - vandermonde() generates a Vandermonde square matrix
+//    - Lazy sums, scalar multiples and transposes (see matrix_expression)
 //
-// Both versions support Gauss and Gauss-Jordan elimination.
-// The square version also supports determinant computation.
+// Both versions support Gauss and Gauss-Jordan elimination over fields (both
+// floating point types and exact fields such as "modular" from modular.hpp),
+// as well as fraction-free (Bareiss) elimination for integral number types.
+// The square version also supports determinant computation, which is
+// exact for exact number types, and (over fields) the characteristic
+// polynomial by reduction to Hessenberg form. lu_factorization solves many
+// systems with the same square matrix.
+//
+// The number type T is classified by std::numeric_limits<T>: types that are
+// not "is_exact" are pivoted by magnitude, exact types by any non-zero entry,
+// and "is_integer" types are eliminated without division. (std::complex has
+// no numeric_limits, so it counts as inexact and is pivoted by std::abs.)
 // Both versions support writing a string representation to
 // an std::basic_ostream.
+//
+// The entries are stored in a scratch_vector, so matrices that are created
+// while an arena is in scope (see arena.hpp) take their memory from it.
 
 #ifndef H_MATRIX
 #define H_MATRIX
@@ -19,20 +33,123 @@
 #include <initializer_list>
 #include <iosfwd>
 #include <iterator>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
+#include "arena.hpp"
 #include "contract.hpp"
+#include "simd.hpp"
 
+template <typename> class matrix;
 template <typename> class square_matrix;
 
+// Lazy matrix expressions: sums, scalar multiples and transposes of matrices
+// are not computed when they are formed, but entry by entry when the
+// expression is assigned to a matrix, so that e.g.
+//
+//    square_matrix<int> n = a + b.transposed() * -t;
+//
+// fills the entries of n directly, without any temporary matrices. An
+// expression E derives from matrix_expression<E> and provides value_type,
+// rows(), cols() and entry(i, j). Expressions refer to the matrices they
+// are formed from, so they must be evaluated before those go away.
+template <typename E>
+struct matrix_expression
+{
+    E const & self() const { return static_cast<E const &>(*this); }
+};
+
+namespace matrix_detail
+{
+    template <typename> class transposed_expression;
+
+    template <typename T> void gauss_eliminate(T * a, std::size_t rows, std::size_t cols,
+                                               bool unit_diagonal, int * swap_count);
+    template <typename T> void bareiss_eliminate(T * a, std::size_t rows, std::size_t cols, int * swap_count);
+    template <typename T> T eliminate_determinant(T * a, std::size_t n);
+    template <typename T> void hessenberg_reduce(T * a, std::size_t n);
+
+    // Whether "a" is a better pivot than "b". Inexact types use partial
+    // pivoting by magnitude; for exact types, any non-zero entry is as good
+    // as any other.
+    template <typename T>
+    bool better_pivot(T const & a, T const & b, std::false_type /* inexact */)
+    {
+        return std::abs(a) > std::abs(b);
+    }
+
+    template <typename T>
+    bool better_pivot(T const & a, T const & b, std::true_type /* exact */)
+    {
+        return b == T(0) && !(a == T(0));
+    }
+
+    // Repeated division by a fixed divisor. Exact types multiply by the
+    // inverse, which is computed only once; inexact types divide every time,
+    // which rounds more accurately.
+    template <typename T, bool = std::numeric_limits<T>::is_exact>
+    class divider
+    {
+    public:
+        explicit divider(T const & d) : d_(d) { }
+        T operator()(T const & x) const { return x / d_; }
+
+    private:
+        T d_;
+    };
+
+    template <typename T>
+    class divider<T, true>
+    {
+    public:
+        explicit divider(T const & d) : inv_(T(1) / d) { }
+        T operator()(T const & x) const { return x * inv_; }
+
+    private:
+        T inv_;
+    };
+
+    // The row operation of elimination: y[i] -= a * x[i] for i in [0, n).
+    // Doubles use the vectorised kernel from simd.hpp.
+    template <typename T>
+    void subtract_scaled(T * y, T const * x, T const & a, std::size_t n)
+    {
+        for (std::size_t i = 0; i != n; ++i) { y[i] -= a * x[i]; }
+    }
+
+    // The number of pivot steps of a panel, and the number of columns of a
+    // tile, in blocked elimination (see matrix<T>::gauss).
+    std::size_t const panel_size = 32;
+    std::size_t const tile_size = 256;
+
+    // Computes x^n; arithmetic types use std::pow, others use repeated squaring.
+    template <typename T>
+    T power(T const & x, std::size_t n, std::true_type /* arithmetic */)
+    {
+        return std::pow(x, n);
+    }
+
+    template <typename T>
+    T power(T x, std::size_t n, std::false_type /* arithmetic */)
+    {
+        T result(1);
+        for (; n != 0; n /= 2, x *= x)
+            if (n % 2 == 1) { result *= x; }
+        return result;
+    }
+}
+
 template <typename T>
-class matrix
+class matrix : public matrix_expression<matrix<T>>
 {
     template <typename> friend class matrix;
     friend class square_matrix<T>;
 
 public:
+    using value_type = T;
+
     explicit matrix(std::size_t rows, std::size_t cols, T const & val)
     : rows_(rows)
     , cols_(cols)
@@ -43,50 +160,73 @@ public:
     : matrix(rows, cols, T())
     { }
 
+    // Evaluates a matrix expression, which may also be a matrix of a
+    // different number type.
+    template <typename E>
+    matrix(matrix_expression<E> const & e)
+    : rows_(e.self().rows())
+    , cols_(e.self().cols())
+    {
+        data_.reserve(rows_ * cols_);
+        for (std::size_t i = 0; i != rows_; ++i)
+            for (std::size_t j = 0; j != cols_; ++j)
+                data_.emplace_back(e.self().entry(i, j));
+    }
+
+    // Evaluates a matrix expression into this matrix, reusing its storage.
+    // The expression must not refer to this matrix.
+    template <typename E>
+    matrix & assign(matrix_expression<E> const & e)
+    {
+        E const & x = e.self();
+        rows_ = x.rows();
+        cols_ = x.cols();
+        data_.resize(rows_ * cols_);
+        for (std::size_t i = 0; i != rows_; ++i)
+        {
+            T * const r = row(i);
+            for (std::size_t j = 0; j != cols_; ++j) { r[j] = x.entry(i, j); }
+        }
+        return *this;
+    }
+
 private:
     // Internal constructor from raw storage
-    explicit matrix(std::size_t rows, std::size_t cols, std::vector<T> data)
+    explicit matrix(std::size_t rows, std::size_t cols, scratch_vector<T> data)
     : rows_(rows)
     , cols_(cols)
     , data_(std::move(data))
     { }
 
 public:
-    template <typename S> operator matrix<S>() const
-    {
-        return matrix<S>(rows_, cols_, std::vector<S>(data_.begin(), data_.end()));
-    }
-
     std::size_t rows() const { return rows_; }
     std::size_t cols() const { return cols_; }
 
     T const & operator()(std::size_t i, std::size_t j) const { assert(i < rows_ && j < cols_); return data_[i * cols_ + j]; }
     T       & operator()(std::size_t i, std::size_t j)       { assert(i < rows_ && j < cols_); return data_[i * cols_ + j]; }
 
-    matrix transpose() const
+    // Unchecked access, for matrix expressions.
+    T const & entry(std::size_t i, std::size_t j) const { return data_[i * cols_ + j]; }
+
+    // A lazy view of the transpose, which refers to this matrix.
+    matrix_detail::transposed_expression<matrix> transposed() const
     {
-        std::vector<T> new_data;
-        new_data.reserve(data_.size());
-        for (std::size_t j = 0; j != cols_; ++j)
-            for (std::size_t i = 0; i != rows_; ++i)
-                new_data.push_back(data_[i * cols_ + j]);
-        return matrix(cols_, rows_, std::move(new_data));
+        return matrix_detail::transposed_expression<matrix>(*this);
     }
 
+    matrix transpose() const { return transposed(); }
+
     // Various elimination forms. See below for details.
     matrix gauss(bool unit_diagonal, int * swap_count) const;
     matrix gauss_jordan() const;
+    matrix bareiss(int * swap_count) const;
 
     // Swapping rows or columns is done on the matrix itself.
     void swap_rows(std::size_t r1, std::size_t r2)
     {
         assert(r1 < rows_ && r2 < rows_);
 
-        for (std::size_t j = 0; j != cols_; ++j)
-        {
-            using std::swap;
-            swap((*this)(r1, j), (*this)(r2, j));
-        }
+        std::swap_ranges(row(r1), row(r1) + cols_, row(r2));
     }
     void swap_cols(std::size_t c1, std::size_t c2)
     {
@@ -99,6 +239,27 @@ public:
         }
     }
 
+    // Returns the submatrix of the given rows and columns, in the given order.
+    // (Cheaper than removing many rows and columns one at a time.)
+    matrix select(std::vector<std::size_t> const & row_indices,
+                  std::vector<std::size_t> const & col_indices) const
+    {
+        scratch_vector<T> new_data;
+        new_data.reserve(row_indices.size() * col_indices.size());
+        for (std::size_t i : row_indices)
+        {
+            CHECK(i < rows_, "Row index out of range!");
+            for (std::size_t j : col_indices)
+            {
+                CHECK(j < cols_, "Column index out of range!");
+                new_data.push_back(data_[i * cols_ + j]);
+            }
+        }
+        return row_indices.empty() || col_indices.empty()
+            ? matrix(0, 0)
+            : matrix(row_indices.size(), col_indices.size(), std::move(new_data));
+    }
+
     // Removing rows and columns is done on the matrix itself.
     void remove_row(std::size_t r)
     {
@@ -122,88 +283,215 @@ public:
         if (cols_ == 0) { rows_ = 0; assert(data_.empty()); }
     }
 
-    matrix<T> operator+(const matrix<T> & rhs) const
+protected:
+    // In-place versions of the elimination forms.
+    void gauss_in_place(bool unit_diagonal, int * swap_count)
     {
-        CHECK(rows() == rhs.rows() && cols() == rhs.cols(), "Trying to add matrices of different sizes!");
-
-        std::vector<T> new_data = data_;
-        for (std::size_t i = 0; i != new_data.size(); ++i) { new_data[i] += rhs.data_[i]; }
-        return matrix(rows_, cols_, std::move(new_data));
+        matrix_detail::gauss_eliminate(data_.data(), rows_, cols_, unit_diagonal, swap_count);
     }
-
-    matrix<T> operator*(const T & x) const
+    void bareiss_in_place(int * swap_count)
     {
-        std::vector<T> new_data = data_;
-        for (T & t : new_data) { t *= x; }
-        return matrix(rows_, cols_, std::move(new_data));
+        matrix_detail::bareiss_eliminate(data_.data(), rows_, cols_, swap_count);
     }
 
-protected:
+    // Unchecked access to the (contiguous) entries of row i.
+    T const * row(std::size_t i) const { return data_.data() + i * cols_; }
+    T       * row(std::size_t i)       { return data_.data() + i * cols_; }
+
     std::size_t rows_;
     std::size_t cols_;
-    std::vector<T> data_;
+    scratch_vector<T> data_;
 };
 
-// Gaussian elimination: returns a row-echelon form; if unit_diagonal is true, then
+namespace matrix_detail
+{
+    // Sub-expressions are stored by value, matrices by reference.
+    template <typename E> struct expression_storage { using type = E; };
+    template <typename T> struct expression_storage<matrix<T>> { using type = matrix<T> const &; };
+
+    template <typename M>
+    class transposed_expression : public matrix_expression<transposed_expression<M>>
+    {
+    public:
+        using value_type = typename M::value_type;
+
+        explicit transposed_expression(M const & m) : m_(m) { }
+
+        std::size_t rows() const { return m_.cols(); }
+        std::size_t cols() const { return m_.rows(); }
+        value_type const & entry(std::size_t i, std::size_t j) const { return m_.entry(j, i); }
+
+    private:
+        M const & m_;
+    };
+
+    template <typename L, typename R>
+    class sum_expression : public matrix_expression<sum_expression<L, R>>
+    {
+        static_assert(std::is_same<typename L::value_type, typename R::value_type>::value,
+                      "Trying to add matrices of different number types!");
+
+    public:
+        using value_type = typename L::value_type;
+
+        sum_expression(L const & lhs, R const & rhs) : lhs_(lhs), rhs_(rhs)
+        {
+            CHECK(lhs.rows() == rhs.rows() && lhs.cols() == rhs.cols(), "Trying to add matrices of different sizes!");
+        }
+
+        std::size_t rows() const { return lhs_.rows(); }
+        std::size_t cols() const { return lhs_.cols(); }
+        value_type entry(std::size_t i, std::size_t j) const { return lhs_.entry(i, j) + rhs_.entry(i, j); }
+
+    private:
+        typename expression_storage<L>::type lhs_;
+        typename expression_storage<R>::type rhs_;
+    };
+
+    template <typename E>
+    class scaled_expression : public matrix_expression<scaled_expression<E>>
+    {
+    public:
+        using value_type = typename E::value_type;
+
+        scaled_expression(E const & e, value_type const & x) : e_(e), x_(x) { }
+
+        std::size_t rows() const { return e_.rows(); }
+        std::size_t cols() const { return e_.cols(); }
+        value_type entry(std::size_t i, std::size_t j) const { return e_.entry(i, j) * x_; }
+
+    private:
+        typename expression_storage<E>::type e_;
+        value_type x_;
+    };
+}
+
+template <typename L, typename R>
+matrix_detail::sum_expression<L, R> operator+(matrix_expression<L> const & lhs, matrix_expression<R> const & rhs)
+{
+    return matrix_detail::sum_expression<L, R>(lhs.self(), rhs.self());
+}
+
+template <typename E>
+matrix_detail::scaled_expression<E> operator*(matrix_expression<E> const & e, typename E::value_type const & x)
+{
+    return matrix_detail::scaled_expression<E>(e.self(), x);
+}
+
+template <typename E>
+matrix_detail::scaled_expression<E> operator*(typename E::value_type const & x, matrix_expression<E> const & e)
+{
+    return matrix_detail::scaled_expression<E>(e.self(), x);
+}
+
+// Gaussian elimination, in place on the rows x cols matrix with row-major entries
+// a (see matrix<T>::gauss): produces a row-echelon form; if unit_diagonal is true, then
 // with "1" along the diagonal. If swap_count is non-null, the pointed-to integer will
 // be incremented for every row swap (which may be needed to determine the sign of the
 // determinant). Requires division.
+//
+// The elimination is blocked: the pivot steps are taken on a panel of columns
+// first, and their row operations are then applied to the remaining columns
+// tile by tile, so that the pivot rows of a panel stay in cache. Every entry
+// receives the same operations in the same order as in unblocked elimination,
+// so the result does not depend on the blocking.
 template <typename T>
-matrix<T> matrix<T>::gauss(bool unit_diagonal, int * swap_count) const
+void matrix_detail::gauss_eliminate(T * a, std::size_t rows, std::size_t cols,
+                                    bool unit_diagonal, int * swap_count)
 {
-    static_assert(std::is_floating_point<T>::value,
+    static_assert(!std::numeric_limits<T>::is_integer,
                   "Gauss elimination can only be performed on a divisible number type.");
 
-    matrix<T> m(*this);
+    using exact = std::integral_constant<bool, std::numeric_limits<T>::is_exact>;
+    using matrix_detail::subtract_scaled;
 
-    for (std::size_t i = 0, j = 0; i < m.rows() && j < m.cols(); ++j /* only j! */)
-    {
-        // Find pivotable row.
-        std::size_t max_i = i;
-        for (std::size_t k = i + 1; k < m.rows(); ++k)
-            if (std::abs(m(k, j)) > std::abs(m(max_i, j)))
-                max_i = k;
+    auto row = [a, cols](std::size_t i) { return a + i * cols; };
 
-        // No action needed if the largest element is already zero.
-        if (m(max_i, j) == 0) { continue; }
+    scratch_vector<std::size_t> pivot_cols;
+    scratch_vector<matrix_detail::divider<T>> dividers;
 
-        // Swap with pivot row.
-        if (i != max_i)
+    for (std::size_t i = 0, j = 0; i < rows && j < cols; )
+    {
+        std::size_t const first_i = i;
+        std::size_t const panel_end = std::min(cols, j + matrix_detail::panel_size);
+        pivot_cols.clear();
+        dividers.clear();
+
+        // Pivot steps within the panel. The multiplier for row k is left
+        // in m(k, j) until the remaining columns have been updated.
+        for (; i < rows && j < panel_end; ++j /* only j! */)
         {
-            m.swap_rows(i, max_i);
-            if (swap_count) { ++*swap_count; }
-        }
+            // Find pivotable row.
+            std::size_t max_i = i;
+            for (std::size_t k = i + 1; k < rows; ++k)
+                if (matrix_detail::better_pivot(row(k)[j], row(max_i)[j], exact()))
+                    max_i = k;
 
-        // Divide each entry in row i by m(i, j);
-        // scale the diagonal to unity if requested.
-        T divisor = m(i, j);
-        if (unit_diagonal)
-        {
-            m(i, j) = T(1);
-            for (std::size_t l = j + 1; l < cols();  ++l)
-                m(i, l) /= divisor;
+            // No action needed if the largest element is already zero.
+            if (row(max_i)[j] == T(0)) { continue; }
+
+            // Swap with pivot row.
+            if (i != max_i)
+            {
+                std::swap_ranges(row(i), row(i) + cols, row(max_i));
+                if (swap_count) { ++*swap_count; }
+            }
+
+            // Divide each entry in row i by m(i, j);
+            // scale the diagonal to unity if requested.
+            T * const pivot_row = row(i);
+            matrix_detail::divider<T> divide(pivot_row[j]);
+            if (unit_diagonal)
+            {
+                pivot_row[j] = T(1);
+                for (std::size_t l = j + 1; l < panel_end; ++l)
+                    pivot_row[l] = divide(pivot_row[l]);
+            }
 
-            for (size_t k = i + 1; k < rows(); ++k)
+            for (std::size_t k = i + 1; k < rows; ++k)
             {
-                T tmp = m(k, j);
-                for (size_t l = 0; l < cols();  ++l)
-                    m(k, l) -= (tmp * m(i, l));
+                T * const r = row(k);
+                r[j] = unit_diagonal ? r[j] : divide(r[j]);
+                subtract_scaled(r + j + 1, pivot_row + j + 1, r[j], panel_end - j - 1);
             }
+
+            pivot_cols.push_back(j);
+            dividers.push_back(divide);
+
+            // Only advance i if we got here.
+            ++i;
         }
-        else
+
+        // Apply the panel's row operations to the remaining columns.
+        for (std::size_t l0 = panel_end; l0 < cols; l0 += matrix_detail::tile_size)
         {
-            for (std::size_t k = i + 1; k < rows(); ++k)
+            std::size_t const n = std::min(cols - l0, matrix_detail::tile_size);
+            for (std::size_t p = 0; p != pivot_cols.size(); ++p)
             {
-                T tmp = m(k, j);
-                for (std::size_t l = 0; l < cols();  ++l)
-                    m(k, l) -= (tmp / divisor * m(i, l));
+                T * const pivot_row = row(first_i + p);
+                if (unit_diagonal)
+                {
+                    for (std::size_t l = l0; l != l0 + n; ++l)
+                        pivot_row[l] = dividers[p](pivot_row[l]);
                 }
+
+                for (std::size_t k = first_i + p + 1; k < rows; ++k)
+                    subtract_scaled(row(k) + l0, pivot_row + l0, row(k)[pivot_cols[p]], n);
+            }
         }
 
-        // Only advance i if we got here.
-        ++i;
+        // Clear the multipliers.
+        for (std::size_t p = 0; p != pivot_cols.size(); ++p)
+            for (std::size_t k = first_i + p + 1; k < rows; ++k)
+                row(k)[pivot_cols[p]] = T(0);
     }
+}
 
+template <typename T>
+matrix<T> matrix<T>::gauss(bool unit_diagonal, int * swap_count) const
+{
+    matrix<T> m(*this);
+    m.gauss_in_place(unit_diagonal, swap_count);
     return m;
 }
 
@@ -216,7 +504,8 @@ matrix<T> matrix<T>::gauss_jordan() const
 
     if (rows() == 0) { return m; }
 
-    // subtract m(i,j) * row(j) from row(i), going backwards
+    // subtract m(i,j) * row(j) from row(i), going backwards; row(j) is zero
+    // left of column j.
     for (std::size_t i = 0; i + 1 < rows(); ++i)
     {
         for (std::size_t j = 0; j < i + 1; ++j)
@@ -224,15 +513,152 @@ matrix<T> matrix<T>::gauss_jordan() const
             std::size_t const ri = rows() - i - 2;
             std::size_t const rj = rows() - j - 1;
 
-            T tmp = m(ri, rj);
-            for (std::size_t l = 0; l != cols(); ++l)
-                m(ri, l) -= tmp * m(rj, l);
+            T const tmp = m.row(ri)[rj];
+            matrix_detail::subtract_scaled(m.row(ri) + rj, m.row(rj) + rj, tmp, cols() - rj);
         }
     }
 
     return m;
 }
 
+// Fraction-free (Bareiss) elimination, in place on the rows x cols matrix with
+// row-major entries a (see matrix<T>::bareiss): produces a row-echelon form in which,
+// after the k-th pivot step, every entry is a (k + 1)-minor of the original
+// matrix, so that all divisions are exact and no fractions arise. The last
+// non-zero diagonal entry of a square matrix of full rank is its determinant
+// (up to the sign given by the row swaps). If swap_count is non-null, the
+// pointed-to integer will be incremented for every row swap. Requires only
+// exact division, so it is suitable for integral number types.
+template <typename T>
+void matrix_detail::bareiss_eliminate(T * a, std::size_t rows, std::size_t cols, int * swap_count)
+{
+    auto row = [a, cols](std::size_t i) { return a + i * cols; };
+    T prev(1);
+
+    for (std::size_t i = 0, j = 0; i < rows && j < cols; ++j /* only j! */)
+    {
+        // Find pivotable row; any non-zero entry will do, since the
+        // division is exact.
+        std::size_t piv_i = i;
+        while (piv_i < rows && row(piv_i)[j] == T(0)) { ++piv_i; }
+
+        // No action needed if the column is already zero.
+        if (piv_i == rows) { continue; }
+
+        // Swap with pivot row.
+        if (i != piv_i)
+        {
+            std::swap_ranges(row(i), row(i) + cols, row(piv_i));
+            if (swap_count) { ++*swap_count; }
+        }
+
+        T const * const pivot_row = row(i);
+        T const pivot = pivot_row[j];
+        for (std::size_t k = i + 1; k < rows; ++k)
+        {
+            T * const r = row(k);
+            T const tmp = r[j];
+            r[j] = T(0);
+            for (std::size_t l = j + 1; l < cols; ++l)
+                r[l] = (r[l] * pivot - tmp * pivot_row[l]) / prev;
+        }
+        prev = pivot;
+
+        // Only advance i if we got here.
+        ++i;
+    }
+}
+
+// Reduction to upper Hessenberg form, in place on the n x n matrix with
+// row-major entries a (see square_matrix<T>::hessenberg): for each column k,
+// a pivot from the rows below the subdiagonal is swapped into row k + 1, and
+// multiples of row k + 1 are subtracted from the rows below it. Each row
+// operation is followed by the inverse column operation, so that the result
+// is similar to the original matrix. Requires division.
+template <typename T>
+void matrix_detail::hessenberg_reduce(T * a, std::size_t n)
+{
+    static_assert(!std::numeric_limits<T>::is_integer,
+                  "Hessenberg reduction can only be performed on a divisible number type.");
+
+    using exact = std::integral_constant<bool, std::numeric_limits<T>::is_exact>;
+    using matrix_detail::subtract_scaled;
+
+    auto row = [a, n](std::size_t i) { return a + i * n; };
+
+    for (std::size_t k = 0; k + 2 < n; ++k)
+    {
+        std::size_t max_i = k + 1;
+        for (std::size_t i = k + 2; i < n; ++i)
+            if (matrix_detail::better_pivot(row(i)[k], row(max_i)[k], exact()))
+                max_i = i;
+
+        if (row(max_i)[k] == T(0)) { continue; }
+
+        // Swap rows and columns k + 1 and max_i.
+        if (max_i != k + 1)
+        {
+            std::swap_ranges(row(k + 1), row(k + 1) + n, row(max_i));
+            for (std::size_t j = 0; j != n; ++j) { std::swap(row(j)[k + 1], row(j)[max_i]); }
+        }
+
+        // Row i -= f * row (k + 1), then column (k + 1) += f * column i.
+        matrix_detail::divider<T> divide(row(k + 1)[k]);
+        for (std::size_t i = k + 2; i < n; ++i)
+        {
+            if (row(i)[k] == T(0)) { continue; }
+
+            T const f = divide(row(i)[k]);
+            row(i)[k] = T(0);
+            subtract_scaled(row(i) + k + 1, row(k + 1) + k + 1, f, n - k - 1);
+            for (std::size_t j = 0; j != n; ++j) { row(j)[k + 1] += f * row(j)[i]; }
+        }
+    }
+}
+
+namespace matrix_detail
+{
+    template <typename T>
+    T eliminate_determinant(T * a, std::size_t n, std::false_type /* field */)
+    {
+        // Gauss elimination followed by multiplying up the diagonal.
+        int swapcount = 0;
+        gauss_eliminate(a, n, n, false, &swapcount);
+        T det(1);
+        for (std::size_t i = 0; i != n; ++i) { det *= a[i * n + i]; }
+        return (swapcount % 2  ?  -det  :  det);
+    }
+
+    template <typename T>
+    T eliminate_determinant(T * a, std::size_t n, std::true_type /* integral */)
+    {
+        // Bareiss elimination leaves the determinant in the bottom right.
+        if (n == 0) { return T(1); }
+
+        int swapcount = 0;
+        bareiss_eliminate(a, n, n, &swapcount);
+        T det = a[n * n - 1];
+        return (swapcount % 2  ?  -det  :  det);
+    }
+}
+
+// Computes the determinant of the n x n matrix with row-major entries a,
+// which are overwritten by the elimination: Gauss elimination for field types
+// and exact fraction-free elimination for integral types.
+template <typename T>
+T matrix_detail::eliminate_determinant(T * a, std::size_t n)
+{
+    return eliminate_determinant(a, n, std::integral_constant<bool, std::numeric_limits<T>::is_integer>());
+}
+
+template <typename T>
+matrix<T> matrix<T>::bareiss(int * swap_count) const
+{
+    matrix<T> m(*this);
+    m.bareiss_in_place(swap_count);
+    return m;
+}
+
 template <typename T>
 class square_matrix : public matrix<T>
 {
@@ -257,6 +683,13 @@ public:
         CHECK_EQ(m.rows(), m.cols(), "Trying to construct square matrix from non-square matrix!");
     }
 
+    template <typename E>
+    square_matrix(matrix_expression<E> const & e)
+    : matrix<T>(e)
+    {
+        CHECK_EQ(this->rows(), this->cols(), "Trying to construct square matrix from non-square matrix!");
+    }
+
     std::size_t dim() const { return this->rows(); }
 
     square_matrix transpose() const
@@ -269,27 +702,175 @@ public:
         return result;
     }
 
+    // The determinant is computed by Gauss elimination for field types and
+    // by exact fraction-free elimination for integral types.
     T determinant() const
     {
-        // Gauss elimination followed by multiplying up the diagonal.
-        int swapcount = 0;
-        square_matrix gaussed = this->gauss(false, &swapcount);
-        T det(1);
-        for (std::size_t i = 0; i != dim(); ++i) { det *= gaussed(i, i); }
-        return (swapcount % 2  ?  -det  :  det);
+        square_matrix m(*this);
+        return m.determinant_in_place();
     }
 
-    square_matrix operator+(square_matrix const & x) const
+    // Computes the determinant by eliminating this matrix in place, which
+    // leaves it in row-echelon form; for matrices used as a workspace.
+    T determinant_in_place()
     {
-        return square_matrix(static_cast<matrix<T> const *>(this)->operator+(x));
+        return matrix_detail::eliminate_determinant(this->data_.data(), dim());
     }
 
-    square_matrix operator*(T const & x) const
+    // Returns a matrix in upper Hessenberg form (zero below the subdiagonal)
+    // that is similar to this one. Requires division.
+    square_matrix hessenberg() const
     {
-        return square_matrix(static_cast<matrix<T> const *>(this)->operator*(x));
+        square_matrix m(*this);
+        matrix_detail::hessenberg_reduce(m.data_.data(), dim());
+        return m;
     }
+
+    // Returns the coefficients of the characteristic polynomial det(t I - A),
+    // starting at degree zero (so the last one is 1). Requires division.
+    scratch_vector<T> characteristic_polynomial() const;
 };
 
+template <typename T>
+scratch_vector<T> square_matrix<T>::characteristic_polynomial() const
+// The characteristic polynomials p_m of the leading m x m submatrices of the
+// Hessenberg form H satisfy (expanding along the last column)
+//
+//    p_m(t) = (t - h_mm) p_{m-1}(t) - sum_{i < m} h_im h_{i+1,i} ... h_{m,m-1} p_{i-1}(t),
+//
+// with 1-based indices and p_0 = 1, which takes O(dim^3) operations in all.
+{
+    square_matrix const h = hessenberg();
+    std::size_t const n = dim();
+
+    scratch_vector<scratch_vector<T>> p(n + 1);
+    p[0].assign(1, T(1));
+
+    for (std::size_t m = 1; m <= n; ++m)
+    {
+        scratch_vector<T> & pm = p[m];
+        scratch_vector<T> const & prev = p[m - 1];
+
+        // (t - h_mm) p_{m-1}
+        pm.assign(m + 1, T(0));
+        for (std::size_t k = 0; k != m; ++k)
+        {
+            pm[k + 1] += prev[k];
+            pm[k] -= h(m - 1, m - 1) * prev[k];
+        }
+
+        T product(1);
+        for (std::size_t i = m - 1; i != 0; --i)
+        {
+            product *= h(i, i - 1);
+            if (product == T(0)) { break; }
+
+            T const f = h(i - 1, m - 1) * product;
+            for (std::size_t k = 0; k != p[i - 1].size(); ++k) { pm[k] -= f * p[i - 1][k]; }
+        }
+    }
+
+    return std::move(p[n]);
+}
+
+// An LU factorization of an invertible square matrix A over a field, for
+// solving many systems A x = b with the same matrix in O(dim^2) operations
+// each:
+//
+//    lu_factorization<double> const lu(a);     // O(dim^3), once
+//    lu.solve_in_place(b);                     // O(dim^2), b becomes x
+//
+// The solution is that of Gauss-Jordan elimination of the augmented matrix
+// (A | b), bit for bit: the factorization records the pivots, multipliers and
+// divisors of that elimination, and solve_in_place() replays its operations
+// on b alone. The factors are kept on the free store rather than in an arena
+// (see arena.hpp), so that a factorization may be cached indefinitely.
+template <typename T>
+class lu_factorization
+{
+public:
+    explicit lu_factorization(square_matrix<T> const & a);
+
+    std::size_t dim() const { return pivots_.size(); }
+
+    template <typename A>
+    void solve_in_place(std::vector<T, A> & b) const;
+
+private:
+    // Row-major; below the diagonal, the multiplier of each row at the time
+    // of the pivot step of its column (rows are not exchanged afterwards);
+    // above it, the reduced pivot rows.
+    std::vector<T> lu_;
+    std::vector<std::size_t> pivots_;               // the row swapped with row j at step j
+    std::vector<matrix_detail::divider<T>> divide_; // the divisor of pivot row j
+};
+
+template <typename T>
+lu_factorization<T>::lu_factorization(square_matrix<T> const & a)
+// The same pivot steps as in matrix_detail::gauss_eliminate() with a unit
+// diagonal, unblocked (which does not change the result), except that row
+// exchanges leave the multipliers of earlier steps in place.
+{
+    static_assert(!std::numeric_limits<T>::is_integer,
+                  "LU factorization can only be performed on a divisible number type.");
+
+    using exact = std::integral_constant<bool, std::numeric_limits<T>::is_exact>;
+
+    std::size_t const n = a.dim();
+    lu_.assign(&a(0, 0), &a(0, 0) + n * n);
+    pivots_.reserve(n);
+    divide_.reserve(n);
+
+    auto row = [this, n](std::size_t i) { return lu_.data() + i * n; };
+
+    for (std::size_t j = 0; j != n; ++j)
+    {
+        std::size_t max_i = j;
+        for (std::size_t k = j + 1; k < n; ++k)
+            if (matrix_detail::better_pivot(row(k)[j], row(max_i)[j], exact()))
+                max_i = k;
+
+        CHECK(!(row(max_i)[j] == T(0)), "Trying to factorize a singular matrix!");
+
+        std::swap_ranges(row(j) + j, row(j) + n, row(max_i) + j);
+        pivots_.push_back(max_i);
+
+        T * const pivot_row = row(j);
+        matrix_detail::divider<T> divide(pivot_row[j]);
+        pivot_row[j] = T(1);
+        for (std::size_t l = j + 1; l < n; ++l) { pivot_row[l] = divide(pivot_row[l]); }
+        divide_.push_back(divide);
+
+        for (std::size_t k = j + 1; k < n; ++k)
+        {
+            T * const r = row(k);
+            matrix_detail::subtract_scaled(r + j + 1, pivot_row + j + 1, r[j], n - j - 1);
+        }
+    }
+}
+
+template <typename T>
+template <typename A>
+void lu_factorization<T>::solve_in_place(std::vector<T, A> & b) const
+{
+    std::size_t const n = dim();
+    assert(b.size() == n);
+
+    // Forward elimination, as in matrix_detail::gauss_eliminate().
+    for (std::size_t j = 0; j != n; ++j)
+    {
+        using std::swap;
+        swap(b[j], b[pivots_[j]]);
+        b[j] = divide_[j](b[j]);
+        for (std::size_t k = j + 1; k < n; ++k) { b[k] -= lu_[k * n + j] * b[j]; }
+    }
+
+    // Back substitution, as in matrix<T>::gauss_jordan().
+    for (std::size_t i = n; i-- > 1; )
+        for (std::size_t j = n; j-- > i; )
+            b[i - 1] -= lu_[(i - 1) * n + j] * b[j];
+}
+
 template <typename T, typename C>
 matrix<T> vandermonde(std::size_t n, C const & data)
 {
@@ -305,7 +886,7 @@ matrix<T> vandermonde(std::size_t n, C const & data)
     {
         for (std::size_t j = 0; j != n; ++j)
         {
-            result(i, j) = std::pow(*it, j);
+            result(i, j) = matrix_detail::power<T>(*it, j, std::is_arithmetic<T>());
         }
         ++it;
     }
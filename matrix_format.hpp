@@ -9,6 +9,8 @@
 //
 //    matrix<int> m = make_a_matrix();
 //    std::cout << "The matrix is:\n" << print(m, 4);
+//
+// Both printers also accept sparse matrices, which are printed like dense ones.
 
 #ifndef H_MATRIX_FORMAT
 #define H_MATRIX_FORMAT
@@ -17,48 +19,61 @@
 #include <iosfwd>
 
 #include "matrix.hpp"
+#include "sparse_matrix.hpp"
 
-template <typename T>
+template <typename M>
 struct matrix_printer
 {
-    matrix<T> const & mat;     // the matrix
+    M const & mat;             // the matrix
     char const * pre;          // per-line prefix (e.g. indentation)
     int wd;                    // field width
 
-    matrix_printer(matrix<T> const & m, char const * p, int w = 0)
+    matrix_printer(M const & m, char const * p, int w = 0)
     : mat(m), pre(p), wd(w) {}
 };
 
-template <typename T>
+template <typename M>
 struct inline_matrix_printer
 {
-    matrix<T> const & mat;     // the matrix
+    M const & mat;             // the matrix
     char const * outer_sep;    // separator between rows
     char const * inner_sep;    // separator between columns
 
-    inline_matrix_printer(matrix<T> const & m, char const * outer, char const * inner)
+    inline_matrix_printer(M const & m, char const * outer, char const * inner)
     : mat(m), outer_sep(outer), inner_sep(inner) {}
 };
 
 // Returns a multi-line matrix pretty printer with the given field width
 // and per-line prefix.
 template <typename T>
-matrix_printer<T> print(matrix<T> const & m, int w, char const * p = "")
+matrix_printer<matrix<T>> print(matrix<T> const & m, int w, char const * p = "")
 {
-    return matrix_printer<T>(m, p, w);
+    return matrix_printer<matrix<T>>(m, p, w);
+}
+
+template <typename T>
+matrix_printer<sparse_matrix<T>> print(sparse_matrix<T> const & m, int w, char const * p = "")
+{
+    return matrix_printer<sparse_matrix<T>>(m, p, w);
 }
 
 // Returns an inline matrix pretty printer with the given row and column
 // separators.
 template <typename T>
-inline_matrix_printer<T> print_inline(matrix<T> const & m, char const * outer = ", ", char const * inner = ", ")
+inline_matrix_printer<matrix<T>> print_inline(matrix<T> const & m, char const * outer = ", ", char const * inner = ", ")
+{
+    return inline_matrix_printer<matrix<T>>(m, outer, inner);
+}
+
+template <typename T>
+inline_matrix_printer<sparse_matrix<T>> print_inline(sparse_matrix<T> const & m, char const * outer = ", ", char const * inner = ", ")
 {
-    return inline_matrix_printer<T>(m, outer, inner);
+    return inline_matrix_printer<sparse_matrix<T>>(m, outer, inner);
 }
 
-template <typename CharT, typename Traits, typename T>
+template <typename CharT, typename Traits, typename M>
 std::basic_ostream<CharT, Traits> & operator<<(std::basic_ostream<CharT, Traits> & os,
-                                               matrix_printer<T> const & mp)
+                                               matrix_printer<M> const & mp)
 {
     if (mp.mat.rows() == 0) { return os << mp.pre << "[]\n"; }
 
@@ -75,9 +90,9 @@ std::basic_ostream<CharT, Traits> & operator<<(std::basic_ostream<CharT, Traits>
     return os;
 }
 
-template <typename CharT, typename Traits, typename T>
+template <typename CharT, typename Traits, typename M>
 std::basic_ostream<CharT, Traits> & operator<<(std::basic_ostream<CharT, Traits> & os,
-                                               inline_matrix_printer<T> const & mp)
+                                               inline_matrix_printer<M> const & mp)
 {
     os << '[';
     for (std::size_t i = 0; i != mp.mat.rows(); ++i)
@@ -1,4 +1,10 @@
+#include <complex>
+#include <random>
+
+#include "fixed_matrix.hpp"
 #include "matrix.hpp"
+#include "modular.hpp"
+#include "simd.hpp"
 #include "testing.hpp"
 
 void TestConstruct()
@@ -44,6 +50,25 @@ void TestRemove()
     EXPECT_EQ(m.cols(), 0u);
 }
 
+void TestSelect()
+{
+    matrix<int> m(3, 3);
+    for (std::size_t i = 0; i != 3; ++i)
+        for (std::size_t j = 0; j != 3; ++j)
+            m(i, j) = int(10 * i + j);
+
+    matrix<int> s = m.select({ 0, 2 }, { 2, 1 });
+    EXPECT_EQ(s.rows(), 2u);
+    EXPECT_EQ(s.cols(), 2u);
+    EXPECT_EQ(s(0, 0),  2); EXPECT_EQ(s(0, 1),  1);
+    EXPECT_EQ(s(1, 0), 22); EXPECT_EQ(s(1, 1), 21);
+
+    // Like removing rows and columns, an empty selection is empty.
+    matrix<int> e = m.select({ 1 }, { });
+    EXPECT_EQ(e.rows(), 0u);
+    EXPECT_EQ(e.cols(), 0u);
+}
+
 void TestScale()
 {
     matrix<int> m(2, 3);
@@ -66,6 +91,67 @@ void TestAdd()
     EXPECT_EQ(m2(1, 0), 27); EXPECT_EQ(m2(1, 1), 24); EXPECT_EQ(m2(1, 2), 21);
 }
 
+void TestExpressions()
+{
+    matrix<int> m(2, 3);
+    m(0, 0) = 1; m(0, 1) = 2; m(0, 2) = 3;
+    m(1, 0) = 9; m(1, 1) = 8; m(1, 2) = 7;
+
+    matrix<int> n(3, 2, 1);
+
+    // m + 2 n^T and -m^T + n, without temporaries.
+    matrix<int> sum = m + 2 * n.transposed();
+    EXPECT_EQ(sum.rows(), 2U);
+    EXPECT_EQ(sum.cols(), 3U);
+    EXPECT_EQ(sum(0, 0),  3); EXPECT_EQ(sum(0, 1),  4); EXPECT_EQ(sum(0, 2), 5);
+    EXPECT_EQ(sum(1, 0), 11); EXPECT_EQ(sum(1, 1), 10); EXPECT_EQ(sum(1, 2), 9);
+
+    matrix<int> t = m.transposed() * -1 + n;
+    EXPECT_EQ(t.rows(), 3U);
+    EXPECT_EQ(t(2, 0), -2); EXPECT_EQ(t(2, 1), -6);
+
+    // Assignment to an existing matrix, and conversion of the number type.
+    square_matrix<long> work(3);
+    square_matrix<int> sq(2, 4);
+    sq(0, 1) = 1;
+    work.assign(sq + sq.transposed() * -3);
+    EXPECT_EQ(work.dim(), 2U);
+    EXPECT_EQ(work(0, 0), -8); EXPECT_EQ(work(0, 1), -11); EXPECT_EQ(work(1, 0), 1);
+    EXPECT_EQ(work.determinant(), 75L);
+    EXPECT_EQ(work.determinant_in_place(), 75L);
+
+    matrix<long> wide = m;
+    EXPECT_EQ(wide(1, 2), 7L);
+}
+
+void TestFixedSize()
+{
+    fixed_square_matrix<long int, 3> m;
+    EXPECT_EQ(m(1, 2), 0L);
+    m(0, 0) = 0; m(0, 1) = 2; m(0, 2) = 1;
+    m(1, 0) = 3; m(1, 1) = 1; m(1, 2) = 4;
+    m(2, 0) = 5; m(2, 1) = 9; m(2, 2) = 2;
+    EXPECT_EQ(m.determinant(), 50L);
+
+    // Expressions and conversion from a dynamic matrix.
+    square_matrix<int> sq(3);
+    for (std::size_t i = 0; i != 3; ++i)
+        for (std::size_t j = 0; j != 3; ++j)
+            sq(i, j) = int(m(i, j));
+
+    fixed_square_matrix<long int, 3> const f(sq);
+    fixed_square_matrix<long int, 3> work;
+    work.assign(f + f.transposed() * -2L);
+    square_matrix<long int> dyn = square_matrix<long int>(sq) + square_matrix<long int>(sq).transposed() * -2L;
+    EXPECT_EQ(work.determinant(), dyn.determinant());
+    EXPECT_EQ(work(1, 0), dyn(1, 0));
+
+    fixed_square_matrix<double, 3> fd(sq);
+    EXPECT_TRUE(std::abs(fd.determinant() - 50.0) < 1e-12);
+
+    EXPECT_EQ((fixed_square_matrix<int, 0>().determinant()), 1);
+}
+
 void TestVandermonde()
 {
     matrix<int> m = vandermonde(3, {2, 3});
@@ -82,6 +168,46 @@ void TestDeterminant()
     EXPECT_EQ(m.determinant(), 19);
 }
 
+void TestIntegerDeterminant()
+{
+    {
+        square_matrix<int> m(2);
+        m(0, 0) = 2; m(0, 1) = 7;
+        m(1, 0) = -3; m(1, 1) = -1;
+        EXPECT_EQ(m.determinant(), 19);
+    }
+
+    {
+        // Needs a row swap.
+        square_matrix<long int> m(3);
+        m(0, 0) = 0; m(0, 1) = 2; m(0, 2) = 1;
+        m(1, 0) = 3; m(1, 1) = 1; m(1, 2) = 4;
+        m(2, 0) = 5; m(2, 1) = 9; m(2, 2) = 2;
+        EXPECT_EQ(m.determinant(), 50);
+    }
+
+    {
+        // Singular.
+        square_matrix<int> m(3);
+        m(0, 0) = 1; m(0, 1) = 2; m(0, 2) = 3;
+        m(1, 0) = 2; m(1, 1) = 4; m(1, 2) = 6;
+        m(2, 0) = 1; m(2, 1) = 0; m(2, 2) = 1;
+        EXPECT_EQ(m.determinant(), 0);
+    }
+
+    {
+        // Large entries whose determinant exceeds the range of long int.
+        __extension__ typedef __int128 int128;
+        square_matrix<int128> m(3, 0);
+        int128 const big = 10000000;
+        m(0, 0) = big; m(1, 1) = big; m(2, 2) = big + 1; m(0, 2) = 1;
+        int128 const expected = big * big * (big + 1);
+        EXPECT_TRUE(m.determinant() == expected);
+    }
+
+    EXPECT_EQ(square_matrix<int>(0).determinant(), 1);
+}
+
 void TestGaussJordanElimination()
 {
     // Data from Wikipedia (http://en.wikipedia.org/wiki/Gaussian_elimination)
@@ -97,14 +223,212 @@ void TestGaussJordanElimination()
     EXPECT_FLOAT_EQ(mgj(2, 3), -1);
 }
 
+void TestComplexDeterminant()
+{
+    using complex = std::complex<double>;
+    complex const i(0, 1);
+
+    // det [[1, i], [i, 1]] = 1 - i^2 = 2.
+    square_matrix<complex> m(2);
+    m(0, 0) = 1; m(0, 1) = i;
+    m(1, 0) = i; m(1, 1) = 1;
+    EXPECT_TRUE(std::abs(m.determinant() - complex(2)) < 1e-15);
+
+    // A row swap is required, and the determinant is complex.
+    square_matrix<complex> n(3);
+    n(0, 1) = 2; n(0, 2) = i;
+    n(1, 0) = complex(1, 1); n(1, 1) = 3;
+    n(2, 0) = 1; n(2, 2) = -1;
+    complex const expected = -(complex(2) * complex(-1, -1) - i * complex(-3));
+    EXPECT_TRUE(std::abs(n.determinant() - expected) < 1e-14);
+}
+
+void TestModularElimination()
+{
+    modular::field_guard guard(1000003);
+
+    square_matrix<modular> m(3);
+    m(0, 0) = 0; m(0, 1) = 2; m(0, 2) = 1;
+    m(1, 0) = 3; m(1, 1) = 1; m(1, 2) = 4;
+    m(2, 0) = 5; m(2, 1) = 9; m(2, 2) = 2;
+    EXPECT_TRUE(m.determinant() == 50);
+
+    // Same system as in TestGaussJordanElimination.
+    matrix<modular> n(3, 4);
+    n(0, 0) =  2; n(0, 1) =  1; n(0, 2) = -1; n(0, 3) =   8;
+    n(1, 0) = -3; n(1, 1) = -1; n(1, 2) =  2; n(1, 3) = -11;
+    n(2, 0) = -2; n(2, 1) =  1; n(2, 2) =  2; n(2, 3) =  -3;
+
+    matrix<modular> ngj = n.gauss_jordan();
+
+    EXPECT_TRUE(ngj(0, 3) ==  2);
+    EXPECT_TRUE(ngj(1, 3) ==  3);
+    EXPECT_TRUE(ngj(2, 3) == -1);
+}
+
+void TestLUFactorization()
+{
+    // The solutions agree exactly with Gauss-Jordan elimination, including
+    // its rounding, for a matrix that requires row exchanges.
+    std::size_t const n = 40;
+    matrix<double> augmented(n, n + 1);
+    square_matrix<double> a(n);
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        for (std::size_t j = 0; j != n; ++j) { a(i, j) = augmented(i, j) = std::sin(double(i * n + j + 1)); }
+        augmented(i, n) = std::cos(double(i));
+    }
+    matrix<double> const reduced = augmented.gauss_jordan();
+
+    lu_factorization<double> const lu(a);
+    std::vector<double> x(n);
+    for (std::size_t i = 0; i != n; ++i) { x[i] = augmented(i, n); }
+    lu.solve_in_place(x);
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i != n; ++i) { if (x[i] != reduced(i, n)) { ++mismatches; } }
+    EXPECT_EQ(mismatches, 0u);
+
+    // The same over GF(p).
+    modular::field_guard guard(1000003);
+    square_matrix<modular> m(3);
+    m(0, 0) = 0; m(0, 1) = 2; m(0, 2) = 1;
+    m(1, 0) = 3; m(1, 1) = 1; m(1, 2) = 4;
+    m(2, 0) = 5; m(2, 1) = 9; m(2, 2) = 2;
+
+    std::vector<modular> y = { 3, 8, 16 };
+    lu_factorization<modular>(m).solve_in_place(y);
+    EXPECT_TRUE(y[0] == 1);
+    EXPECT_TRUE(y[1] == 1);
+    EXPECT_TRUE(y[2] == 1);
+}
+
+void TestCharacteristicPolynomial()
+{
+    modular::field_guard guard(1000003);
+
+    // det(t I - A) = t^3 - tr(A) t^2 + (sum of principal 2-minors) t - det(A).
+    square_matrix<modular> m(3);
+    m(0, 0) = 0; m(0, 1) = 2; m(0, 2) = 1;
+    m(1, 0) = 3; m(1, 1) = 1; m(1, 2) = 4;
+    m(2, 0) = 5; m(2, 1) = 9; m(2, 2) = 2;
+    scratch_vector<modular> const chi = m.characteristic_polynomial();
+    EXPECT_EQ(chi.size(), 4u);
+    EXPECT_TRUE(chi[0] == -50);
+    EXPECT_TRUE(chi[1] == -45);
+    EXPECT_TRUE(chi[2] == -3);
+    EXPECT_TRUE(chi[3] == 1);
+
+    // A sparse matrix, which requires row and column swaps and skips zero
+    // columns; compare with det(t I - A) at several points.
+    std::size_t const d = 9;
+    square_matrix<modular> s(d);
+    for (std::size_t i = 0; i != d; ++i)
+        for (std::size_t j = 0; j != d; ++j)
+            if ((i * 7 + j * 3) % 5 == 0) { s(i, j) = long(i + 2 * j) - 7; }
+
+    square_matrix<modular> h = s.hessenberg();
+    for (std::size_t i = 2; i < d; ++i)
+        for (std::size_t j = 0; j + 1 < i; ++j)
+            EXPECT_TRUE(h(i, j) == 0);
+
+    scratch_vector<modular> const cs = s.characteristic_polynomial();
+    for (long int t = 0; t != 5; ++t)
+    {
+        square_matrix<modular> shifted = s * modular(-1);
+        for (std::size_t i = 0; i != d; ++i) { shifted(i, i) += t; }
+
+        modular value = 0;
+        for (std::size_t k = cs.size(); k-- != 0; ) { value = value * t + cs[k]; }
+        EXPECT_TRUE(value == shifted.determinant());
+    }
+
+    EXPECT_EQ(square_matrix<modular>(0).characteristic_polynomial().size(), 1u);
+}
+
+// Plain unblocked Gauss elimination, as a reference for the blocked one.
+matrix<double> reference_gauss(matrix<double> m, bool unit_diagonal)
+{
+    for (std::size_t i = 0, j = 0; i < m.rows() && j < m.cols(); ++j)
+    {
+        std::size_t max_i = i;
+        for (std::size_t k = i + 1; k < m.rows(); ++k)
+            if (std::abs(m(k, j)) > std::abs(m(max_i, j))) { max_i = k; }
+        if (m(max_i, j) == 0) { continue; }
+        m.swap_rows(i, max_i);
+
+        double const divisor = m(i, j);
+        if (unit_diagonal)
+        {
+            for (std::size_t l = j; l < m.cols(); ++l) { m(i, l) /= divisor; }
+        }
+        for (std::size_t k = i + 1; k < m.rows(); ++k)
+        {
+            double const tmp = unit_diagonal ? m(k, j) : m(k, j) / divisor;
+            for (std::size_t l = j + 1; l < m.cols(); ++l) { m(k, l) -= tmp * m(i, l); }
+            m(k, j) = 0;
+        }
+        ++i;
+    }
+    return m;
+}
+
+void TestBlockedElimination()
+{
+    std::cout << "INFO: Using the " << simd_kernel_name() << " elimination kernel.\n";
+
+    // Several panels and tiles, and a zero column within the first panel.
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    matrix<double> m(70, 300);
+    for (std::size_t i = 0; i != m.rows(); ++i)
+        for (std::size_t j = 0; j != m.cols(); ++j)
+            m(i, j) = j == 5 ? 0 : dist(gen);
+
+    for (bool unit_diagonal : { false, true })
+    {
+        matrix<double> const blocked = m.gauss(unit_diagonal, nullptr);
+        matrix<double> const reference = reference_gauss(m, unit_diagonal);
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i != m.rows(); ++i)
+            for (std::size_t j = 0; j != m.cols(); ++j)
+                if (blocked(i, j) != reference(i, j)) { ++mismatches; }
+        EXPECT_EQ(mismatches, 0U);
+    }
+
+    // The kernel on unaligned ranges of every length modulo the vector width.
+    std::vector<double> x(40), y(40);
+    for (std::size_t i = 0; i != x.size(); ++i) { x[i] = dist(gen); y[i] = dist(gen); }
+    for (std::size_t n = 0; n != 20; ++n)
+    {
+        std::vector<double> z = y;
+        matrix_detail::subtract_scaled(z.data() + 1, x.data() + 3, 0.375, n);
+        for (std::size_t i = 0; i != z.size(); ++i)
+        {
+            double const expected = i >= 1 && i < n + 1 ? y[i] - 0.375 * x[i + 2] : y[i];
+            EXPECT_EQ(z[i], expected);
+        }
+    }
+}
+
 int main()
 {
     TestConstruct();
     TestTranspose();
     TestRemove();
+    TestSelect();
     TestScale();
     TestAdd();
+    TestExpressions();
+    TestFixedSize();
     TestVandermonde();
     TestDeterminant();
+    TestIntegerDeterminant();
     TestGaussJordanElimination();
+    TestComplexDeterminant();
+    TestModularElimination();
+    TestLUFactorization();
+    TestCharacteristicPolynomial();
+    TestBlockedElimination();
 }
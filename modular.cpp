@@ -0,0 +1,101 @@
+#include <ostream>
+
+#include "contract.hpp"
+#include "modular.hpp"
+
+namespace
+{
+    __extension__ typedef unsigned __int128 wide;
+
+    std::uint64_t mul_mod(std::uint64_t a, std::uint64_t b, std::uint64_t n)
+    {
+        return static_cast<std::uint64_t>(static_cast<wide>(a) * b % n);
+    }
+
+    std::uint64_t pow_mod(std::uint64_t a, std::uint64_t e, std::uint64_t n)
+    {
+        std::uint64_t result = 1 % n;
+        for (a %= n; e != 0; e /= 2, a = mul_mod(a, a, n))
+            if (e % 2 == 1) { result = mul_mod(result, a, n); }
+        return result;
+    }
+}
+
+modular::field_guard::field_guard(std::uint64_t p)
+: prev_(current())
+{
+    CHECK(p % 2 == 1 && p < (std::uint64_t(1) << 62), "Modulus must be an odd number less than 2^62.");
+
+    // Newton iteration for p^{-1} mod 2^64; each step doubles the number of
+    // correct low bits, starting from three (p * p == 1 mod 8 for odd p).
+    std::uint64_t inv = p;
+    for (int i = 0; i != 5; ++i) { inv *= 2 - p * inv; }
+
+    std::uint64_t const r = (0 - p) % p;   // 2^64 mod p
+
+    current().p = p;
+    current().pinv = 0 - inv;
+    current().r2 = mul_mod(r, r, p);
+}
+
+modular modular::inverse() const
+{
+    CHECK(v_ != 0, "Trying to invert zero!");
+
+    modular result = 1, x = *this;
+    for (std::uint64_t e = prime() - 2; e != 0; e /= 2, x *= x)
+        if (e % 2 == 1) { result *= x; }
+    return result;
+}
+
+std::ostream & operator<<(std::ostream & os, modular const & x)
+{
+    return os << x.value();
+}
+
+bool is_prime(std::uint64_t n)
+// Miller-Rabin test with a set of bases that is known to be deterministic for
+// all n < 2^64.
+{
+    if (n < 2) { return false; }
+
+    std::uint64_t const bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+    for (std::uint64_t b : bases)
+    {
+        if (n % b == 0) { return n == b; }
+    }
+
+    std::uint64_t d = n - 1;
+    int s = 0;
+    while (d % 2 == 0) { d /= 2; ++s; }
+
+    for (std::uint64_t b : bases)
+    {
+        std::uint64_t x = pow_mod(b, d, n);
+        if (x == 1 || x == n - 1) { continue; }
+
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r)
+        {
+            x = mul_mod(x, x, n);
+            if (x == n - 1) { composite = false; }
+        }
+        if (composite) { return false; }
+    }
+
+    return true;
+}
+
+std::vector<std::uint64_t> large_primes(std::size_t count)
+{
+    std::vector<std::uint64_t> result;
+    result.reserve(count);
+
+    for (std::uint64_t n = (std::uint64_t(1) << 62) - 1; result.size() != count; n -= 2)
+    {
+        if (is_prime(n)) { result.push_back(n); }
+    }
+
+    return result;
+}
@@ -0,0 +1,142 @@
+// Arithmetic in prime fields GF(p) for odd primes p < 2^62:
+//
+//    modular::field_guard g(p);     // select GF(p) on this thread
+//    modular a = 3, b = -1;
+//    modular c = a / b;             // c.value() == p - 3
+//
+// The modulus is a per-thread setting that is selected by a field_guard for
+// the guard's lifetime (guards nest). An element must only be used while the
+// field in which it was created is in effect. Elements are stored in
+// Montgomery form, so that multiplication requires no division.
+//
+// Since std::numeric_limits<modular> is exact but not integral, matrices of
+// modular elements are eliminated by ordinary Gauss elimination (see
+// matrix.hpp).
+
+#ifndef H_MODULAR
+#define H_MODULAR
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <vector>
+
+class modular
+{
+    __extension__ typedef unsigned __int128 wide;
+
+    // Parameters of the current prime field.
+    struct field
+    {
+        std::uint64_t p;      // the prime
+        std::uint64_t pinv;   // -p^{-1} mod 2^64
+        std::uint64_t r2;     // 2^128 mod p
+    };
+
+    static field & current()
+    {
+        static thread_local field f = { 0, 0, 0 };
+        return f;
+    }
+
+    // Montgomery reduction: returns x * 2^-64 mod p, for x < p * 2^64.
+    static std::uint64_t redc(wide x)
+    {
+        field const & f = current();
+        std::uint64_t m = static_cast<std::uint64_t>(x) * f.pinv;
+        std::uint64_t t = static_cast<std::uint64_t>((x + static_cast<wide>(m) * f.p) >> 64);
+        return t >= f.p ? t - f.p : t;
+    }
+
+public:
+    class field_guard
+    {
+    public:
+        // Requires that p be an odd prime less than 2^62.
+        explicit field_guard(std::uint64_t p);
+        ~field_guard() { current() = prev_; }
+
+        field_guard(field_guard const &) = delete;
+        field_guard & operator=(field_guard const &) = delete;
+
+    private:
+        field prev_;
+    };
+
+    // The prime of the current field.
+    static std::uint64_t prime() { return current().p; }
+
+    modular() : v_(0) { }
+
+    modular(long int n)
+    : v_(redc(static_cast<wide>(reduce(n)) * current().r2))
+    { }
+
+    // The canonical representative in [0, p).
+    std::uint64_t value() const { return redc(v_); }
+
+    modular & operator+=(modular const & rhs)
+    {
+        v_ += rhs.v_;
+        if (v_ >= prime()) { v_ -= prime(); }
+        return *this;
+    }
+
+    modular & operator-=(modular const & rhs)
+    {
+        v_ = v_ >= rhs.v_ ? v_ - rhs.v_ : v_ + prime() - rhs.v_;
+        return *this;
+    }
+
+    modular & operator*=(modular const & rhs)
+    {
+        v_ = redc(static_cast<wide>(v_) * rhs.v_);
+        return *this;
+    }
+
+    modular & operator/=(modular const & rhs) { return *this *= rhs.inverse(); }
+
+    modular operator-() const { return modular() - *this; }
+
+    // The multiplicative inverse (by Fermat's little theorem). Requires that
+    // the element be non-zero.
+    modular inverse() const;
+
+    friend modular operator+(modular a, modular const & b) { return a += b; }
+    friend modular operator-(modular a, modular const & b) { return a -= b; }
+    friend modular operator*(modular a, modular const & b) { return a *= b; }
+    friend modular operator/(modular a, modular const & b) { return a /= b; }
+
+    friend bool operator==(modular const & a, modular const & b) { return a.v_ == b.v_; }
+    friend bool operator!=(modular const & a, modular const & b) { return a.v_ != b.v_; }
+
+private:
+    static std::uint64_t reduce(long int n)
+    {
+        std::uint64_t const p = prime();
+        return n < 0 ? (p - (0 - static_cast<std::uint64_t>(n)) % p) % p
+                     : static_cast<std::uint64_t>(n) % p;
+    }
+
+    std::uint64_t v_;    // Montgomery form: value * 2^64 mod p
+};
+
+std::ostream & operator<<(std::ostream & os, modular const & x);
+
+namespace std
+{
+    template <> struct numeric_limits<modular>
+    {
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_exact = true;
+        static constexpr bool is_integer = false;
+    };
+}
+
+// Returns whether n is prime (deterministic for all 64-bit numbers).
+bool is_prime(std::uint64_t n);
+
+// Returns the "count" largest primes below 2^62, in descending order.
+std::vector<std::uint64_t> large_primes(std::size_t count);
+
+#endif
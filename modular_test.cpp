@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <vector>
+
+#include "modular.hpp"
+#include "testing.hpp"
+
+void TestArithmetic()
+{
+    modular::field_guard guard(101);
+
+    modular x = 3, y = -1, z = 200;
+    EXPECT_EQ(x.value(), 3u);
+    EXPECT_EQ(y.value(), 100u);
+    EXPECT_EQ(z.value(), 99u);
+
+    EXPECT_EQ((x + y).value(), 2u);
+    EXPECT_EQ((y - x).value(), 97u);
+    EXPECT_EQ((x * z).value(), 95u);
+    EXPECT_EQ((-x).value(), 98u);
+    EXPECT_EQ((x / y).value(), 98u);
+    EXPECT_TRUE(x * x.inverse() == modular(1));
+    EXPECT_TRUE(modular() == modular(0));
+    EXPECT_TRUE(modular(101) == 0);
+}
+
+void TestLargePrime()
+{
+    std::uint64_t const p = 4611686018427387847u;   // 2^62 - 57
+    modular::field_guard guard(p);
+
+    modular x = -2;
+    EXPECT_EQ(x.value(), p - 2);
+    EXPECT_EQ((x * x).value(), 4u);
+    EXPECT_TRUE(x / x == 1);
+
+    // (2^31)^2 = 2^62 = 57 mod p.
+    modular y = 1L << 31;
+    EXPECT_EQ((y * y).value(), 57u);
+}
+
+void TestGuardNesting()
+{
+    modular::field_guard outer(7);
+    {
+        modular::field_guard inner(11);
+        EXPECT_EQ(modular::prime(), 11u);
+        EXPECT_EQ(modular(13).value(), 2u);
+    }
+    EXPECT_EQ(modular::prime(), 7u);
+    EXPECT_EQ(modular(13).value(), 6u);
+}
+
+void TestPrimes()
+{
+    EXPECT_FALSE(is_prime(0));
+    EXPECT_FALSE(is_prime(1));
+    EXPECT_TRUE(is_prime(2));
+    EXPECT_TRUE(is_prime(97));
+    EXPECT_FALSE(is_prime(561));                      // Carmichael number
+    EXPECT_FALSE(is_prime(3215031751u));              // strong pseudoprime to bases 2, 3, 5, 7
+    EXPECT_TRUE(is_prime(4611686018427387847u));      // 2^62 - 57
+
+    std::vector<std::uint64_t> primes = large_primes(3);
+    EXPECT_EQ(primes.size(), 3u);
+    EXPECT_EQ(primes[0], 4611686018427387847u);
+    EXPECT_TRUE(primes[0] > primes[1] && primes[1] > primes[2]);
+    EXPECT_TRUE(is_prime(primes[2]));
+}
+
+int main()
+{
+    TestArithmetic();
+    TestLargePrime();
+    TestGuardNesting();
+    TestPrimes();
+}
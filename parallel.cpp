@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace
+{
+    // A fixed set of helper threads that run one job at a time. A job is a
+    // function of the thread index k in [0, size()); index 0 is run on the
+    // thread that submits the job.
+    class thread_pool
+    {
+    public:
+        explicit thread_pool(std::size_t threads)
+        : job_(nullptr), generation_(0), busy_(0), stop_(false)
+        {
+            for (std::size_t k = 1; k < threads; ++k) { helpers_.emplace_back(&thread_pool::work, this, k); }
+        }
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (std::thread & t : helpers_) { t.join(); }
+        }
+
+        thread_pool(thread_pool const &) = delete;
+        thread_pool & operator=(thread_pool const &) = delete;
+
+        std::size_t size() const { return helpers_.size() + 1; }
+
+        void run(std::function<void(std::size_t)> const & job)
+        {
+            std::lock_guard<std::mutex> serial(run_mutex_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job_ = &job;
+                busy_ = helpers_.size();
+                error_ = nullptr;
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            call(job, 0);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return busy_ == 0; });
+            job_ = nullptr;
+
+            if (error_) { std::rethrow_exception(error_); }
+        }
+
+        // Whether the current thread is running a job.
+        static bool & in_job()
+        {
+            static thread_local bool b = false;
+            return b;
+        }
+
+    private:
+        void call(std::function<void(std::size_t)> const & job, std::size_t k)
+        {
+            in_job() = true;
+            try
+            {
+                job(k);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+            }
+            in_job() = false;
+        }
+
+        void work(std::size_t k)
+        {
+            std::size_t seen = 0;
+            for (;;)
+            {
+                std::function<void(std::size_t)> const * job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+                    if (stop_) { return; }
+                    seen = generation_;
+                    job = job_;
+                }
+
+                call(*job, k);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--busy_ == 0) { done_.notify_one(); }
+            }
+        }
+
+        std::vector<std::thread> helpers_;
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::function<void(std::size_t)> const * job_;
+        std::size_t generation_;
+        std::size_t busy_;
+        bool stop_;
+        std::exception_ptr error_;
+    };
+
+    std::unique_ptr<thread_pool> & global_pool()
+    {
+        static std::unique_ptr<thread_pool> pool;
+        return pool;
+    }
+}
+
+void set_parallelism(std::size_t threads)
+{
+    if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+    global_pool().reset();
+    if (threads > 1) { global_pool().reset(new thread_pool(threads)); }
+}
+
+std::size_t parallelism()
+{
+    return global_pool() ? global_pool()->size() : 1;
+}
+
+void parallel_for(std::size_t n, std::function<void(std::size_t, std::size_t)> const & f)
+{
+    std::size_t const chunks = std::min(n, parallelism());
+
+    if (chunks <= 1 || thread_pool::in_job())
+    {
+        if (n != 0) { f(0, n); }
+        return;
+    }
+
+    global_pool()->run([&](std::size_t k)
+    {
+        if (k < chunks) { f(n * k / chunks, n * (k + 1) / chunks); }
+    });
+}
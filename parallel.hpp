@@ -0,0 +1,41 @@
+// Data parallelism over a process-wide thread pool:
+//
+//    set_parallelism(8);                  // e.g. from the command line
+//    parallel_for(n, [&](std::size_t first, std::size_t last)
+//    {
+//        workspace w;                     // one per chunk, reused within it
+//        for (std::size_t i = first; i != last; ++i) { result[i] = f(i, w); }
+//    });
+//
+// parallel_for() splits [0, n) into at most parallelism() contiguous chunks
+// and processes them concurrently, one per thread, the first of them on the
+// calling thread. The split depends only on n and parallelism(), so a task
+// that computes every result from its index alone produces the same results
+// regardless of scheduling. With a parallelism of one (the default), or when
+// called from within a task, parallel_for() simply calls f(0, n).
+//
+// Per-thread settings do not carry over into the tasks: a task that uses
+// modular arithmetic must select the field itself (see modular.hpp), and
+// tasks allocate from the free store rather than from the caller's arena
+// (see arena.hpp), so they must not release memory that the caller allocated
+// from one.
+
+#ifndef H_PARALLEL
+#define H_PARALLEL
+
+#include <cstddef>
+#include <functional>
+
+// Sets the number of threads that parallel_for() uses, including the calling
+// thread. Zero selects the number of hardware threads. Must not be called
+// while a parallel_for() is running.
+void set_parallelism(std::size_t threads);
+
+std::size_t parallelism();
+
+// Calls f(first, last) for contiguous chunks [first, last) that partition
+// [0, n), concurrently; returns when all calls have returned. If a call
+// throws, one of the exceptions is rethrown after all calls have finished.
+void parallel_for(std::size_t n, std::function<void(std::size_t, std::size_t)> const & f);
+
+#endif
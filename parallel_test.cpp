@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+#include "testing.hpp"
+
+// The chunks passed to f, sorted by their first index.
+std::vector<std::pair<std::size_t, std::size_t>> chunks(std::size_t n)
+{
+    std::mutex mutex;
+    std::vector<std::pair<std::size_t, std::size_t>> r;
+    parallel_for(n, [&](std::size_t first, std::size_t last)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        r.emplace_back(first, last);
+    });
+    std::sort(r.begin(), r.end());
+    return r;
+}
+
+void TestSerial()
+{
+    set_parallelism(1);
+    EXPECT_EQ(parallelism(), 1u);
+
+    auto c = chunks(10);
+    EXPECT_EQ(c.size(), 1u);
+    EXPECT_EQ(c[0].first, 0u);
+    EXPECT_EQ(c[0].second, 10u);
+
+    EXPECT_TRUE(chunks(0).empty());
+}
+
+void TestPartition()
+{
+    set_parallelism(4);
+    EXPECT_EQ(parallelism(), 4u);
+
+    for (std::size_t n : { 1, 3, 4, 5, 17, 1000 })
+    {
+        auto c = chunks(n);
+        EXPECT_EQ(c.size(), n < 4 ? n : 4);
+
+        // The chunks are non-empty and cover [0, n) exactly once.
+        std::size_t next = 0;
+        for (auto const & chunk : c)
+        {
+            EXPECT_EQ(chunk.first, next);
+            EXPECT_TRUE(chunk.first < chunk.second);
+            next = chunk.second;
+        }
+        EXPECT_EQ(next, n);
+
+        // The split is the same every time.
+        EXPECT_TRUE(chunks(n) == c);
+    }
+
+    std::vector<int> squares(1000);
+    parallel_for(squares.size(), [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t i = first; i != last; ++i) { squares[i] = int(i * i); }
+    });
+    for (std::size_t i = 0; i != squares.size(); ++i) { EXPECT_EQ(squares[i], int(i * i)); }
+
+    set_parallelism(1);
+}
+
+void TestNested()
+{
+    set_parallelism(3);
+
+    std::atomic<std::size_t> total(0);
+    parallel_for(3, [&](std::size_t, std::size_t)
+    {
+        // Runs serially on the thread of the enclosing task.
+        std::size_t calls = 0;
+        parallel_for(10, [&](std::size_t first, std::size_t last)
+        {
+            ++calls;
+            total += last - first;
+        });
+        EXPECT_EQ(calls, 1u);
+    });
+    EXPECT_EQ(total.load(), 30u);
+
+    set_parallelism(1);
+}
+
+void TestException()
+{
+    set_parallelism(4);
+
+    std::atomic<int> calls(0);
+    bool caught = false;
+    try
+    {
+        parallel_for(8, [&](std::size_t first, std::size_t)
+        {
+            ++calls;
+            if (first != 0) { throw std::runtime_error("chunk"); }
+        });
+    }
+    catch (std::runtime_error const &)
+    {
+        caught = true;
+    }
+    EXPECT_TRUE(caught);
+    EXPECT_EQ(calls.load(), 4);
+
+    // The pool remains usable.
+    EXPECT_EQ(chunks(8).size(), 4u);
+
+    set_parallelism(1);
+}
+
+int main()
+{
+    TestSerial();
+    TestPartition();
+    TestNested();
+    TestException();
+}
@@ -5,16 +5,23 @@
 #include <iterator>
 #include <string>
 
-// Format a range of coefficients, starting at the coefficient of the term of
-// degree zero, into a polynomial in one indeterminate, which is given by "sym".
+// Format a range of coefficients into a Laurent polynomial in one indeterminate,
+// which is given by "sym". The first coefficient is that of the term of degree
+// lowest / denominator, and each subsequent one that of a degree higher by
+// 1 / denominator, so that for example half-integral degrees can be formatted
+// with a denominator of 2 (as in "t^(3/2)"). The coefficients are formatted by
+// an unqualified call of "to_string", so that number types other than the
+// built-in ones may provide an overload.
 template <typename Iter>
-std::string polynomial_to_string(std::string const & sym, Iter it, Iter last)
+std::string laurent_polynomial_to_string(std::string const & sym, long int lowest, long int denominator,
+                                         Iter it, Iter last)
 {
     using T = typename std::iterator_traits<Iter>::value_type;
     using RI = std::reverse_iterator<Iter>;
+    using std::to_string;
 
     std::string result;
-    std::size_t deg = std::distance(it, last) - 1;
+    long int deg = lowest + std::distance(it, last) - 1;
 
     for (RI rit(last), rlast(it); rit != rlast; ++rit, --deg)
     {
@@ -37,10 +44,20 @@ std::string polynomial_to_string(std::string const & sym, Iter it, Iter last)
         if (deg != 0 && val != 1) { mult = " * "; }
 
         result += prefix;
-        if (deg == 0 || val != 1) { result += std::to_string(val);       }
+        if (deg == 0 || val != 1) { result += to_string(val); }
         result += mult;
-        if (deg > 0)              { result += sym;                       }
-        if (deg > 1)              { result += '^' + std::to_string(deg); }
+        if (deg != 0)             { result += sym;            }
+
+        if (deg != 0 && deg != denominator)
+        {
+            // The degree in lowest terms, p / q.
+            long int a = deg < 0 ? -deg : deg, b = denominator;
+            while (b != 0) { long int r = a % b; a = b; b = r; }
+            long int const p = deg / a, q = denominator / a;
+
+            if (q == 1) { result += '^' + std::to_string(p);                                 }
+            else        { result += "^(" + std::to_string(p) + '/' + std::to_string(q) + ')'; }
+        }
     }
 
     if (result.empty()) { result = "0"; }
@@ -48,6 +65,14 @@ std::string polynomial_to_string(std::string const & sym, Iter it, Iter last)
     return result;
 }
 
+// Format a range of coefficients, starting at the coefficient of the term of
+// degree zero, into a polynomial in one indeterminate, which is given by "sym".
+template <typename Iter>
+std::string polynomial_to_string(std::string const & sym, Iter it, Iter last)
+{
+    return laurent_polynomial_to_string(sym, 0, 1, it, last);
+}
+
 template <typename T>
 std::string polynomial_to_string(std::string const & sym, std::initializer_list<T> il)
 {
@@ -1,3 +1,6 @@
+#include <vector>
+
+#include "bigint.hpp"
 #include "polynomial_format.hpp"
 #include "testing.hpp"
 
@@ -37,10 +40,34 @@ void TestOther()
     EXPECT_EQ(polynomial_to_string("t", wrap({2, -3})),  "-3 * t + 2");
 }
 
+void TestBigint()
+{
+    bigint big = 1;
+    for (int i = 0; i != 10; ++i) { big *= 1000; }
+
+    std::vector<bigint> coeffs = { -big, 0, 1, -1 };
+    EXPECT_EQ(polynomial_to_string("t", coeffs.begin(), coeffs.end()),
+              "-t^3 + t^2 - 1000000000000000000000000000000");
+}
+
+void TestLaurent()
+{
+    std::vector<int> jones = { -1, 0, 1, 0, 0, 0, 1 };
+    EXPECT_EQ(laurent_polynomial_to_string("t", -4, 1, jones.begin(), jones.end()), "t^2 + t^-2 - t^-4");
+    EXPECT_EQ(laurent_polynomial_to_string("t", -1, 1, jones.begin(), jones.end()), "t^5 + t - t^-1");
+
+    std::vector<int> hopf = { -1, 0, 0, 0, -1 };
+    EXPECT_EQ(laurent_polynomial_to_string("t", 1, 2, hopf.begin(), hopf.end()), "-t^(5/2) - t^(1/2)");
+    EXPECT_EQ(laurent_polynomial_to_string("t", -3, 2, hopf.begin(), hopf.end()), "-t^(1/2) - t^(-3/2)");
+    EXPECT_EQ(laurent_polynomial_to_string("t", -2, 2, hopf.begin(), hopf.end()), "-t - t^-1");
+}
+
 int main()
 {
     TestZero();
     TestConstant();
     TestMonic();
     TestOther();
+    TestBigint();
+    TestLaurent();
 }
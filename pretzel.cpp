@@ -1,3 +1,4 @@
+#include <limits>
 #include <sstream>
 #include <string>
 
@@ -18,6 +19,8 @@ namespace
     // twisting number is always +/- 1.
     bool add_braid_twist(long int s, pretzel * out)
     {
+        if (s < -std::numeric_limits<int>::max() || s > std::numeric_limits<int>::max()) { return false; }
+
         if      (s < 0) { out->emplace_back(-s, -1); return true; }
         else if (s > 0) { out->emplace_back(+s, +1); return true; }
         else            { return false;                           }
@@ -44,6 +47,8 @@ namespace
             if (iss >> tw)
             {
                 if (tw % 2 == 0) { return false;             }
+                if (tw < -std::numeric_limits<int>::max() ||
+                    tw > std::numeric_limits<int>::max())  { return false; }
                 if (s < 0) { s *= -1; tw *= -1; }
                 out->emplace_back(s, tw);
             }
@@ -114,7 +119,7 @@ namespace
     }
 }
 
-void print_pretzel(pretzel const & pr, std::ostream & os, const char * prefix)
+void print_pretzel(pretzel_view pr, std::ostream & os, const char * prefix)
 {
     std::size_t n = number_of_strands(pr);  // height
     std::size_t l = 5 * pr.size();          // width
@@ -3,10 +3,14 @@
 #ifndef H_PRETZEL
 #define H_PRETZEL
 
+#include <cstddef>
 #include <iosfwd>
+#include <iterator>
 #include <utility>
 #include <vector>
 
+#include "arena.hpp"
+
 // A pretzel is a representation of a link, given as a sequence of twists of N
 // strands. We represent the "pretzel" type as a sequence of twists, where a
 // "twist" is represented as a pair of a strand number and a twisting count. For
@@ -43,9 +47,90 @@
 // can be more compact than an equivalent braid representation.
 //
 // See http://www.maths.ed.ac.uk/~jcollins/SeifertMatrix/ for details.
+//
+// Pretzels are stored in a scratch_vector, so that a pretzel that is created
+// while an arena is in scope takes its memory from it (see arena.hpp).
 
 using twist = std::pair<unsigned int, int>;
-using pretzel = std::vector<twist>;
+using pretzel = scratch_vector<twist>;
+
+// A read-only view of a contiguous range of the twists of a pretzel, seen as a
+// pretzel of its own whose strand numbers are those of the underlying twists
+// minus "offset". Views are cheap to copy, and a pretzel converts implicitly
+// to a view of itself (with offset zero), so that the algorithms that take
+// views apply to both. The underlying pretzel must outlive the view and must
+// not be modified while the view is in use.
+//
+// For example, the view of the twists "BDB" of "ABDBE" with offset 1 is the
+// pretzel "ACA".
+class pretzel_view
+{
+public:
+    // Random access to the twists (with the offset applied), by value.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = twist;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = twist;
+
+        const_iterator() : it_(nullptr), offset_(0) { }
+        const_iterator(twist const * it, unsigned int offset) : it_(it), offset_(offset) { }
+
+        twist operator*() const { return twist(it_->first - offset_, it_->second); }
+        twist operator[](difference_type n) const { return *(*this + n); }
+
+        const_iterator & operator++() { ++it_; return *this; }
+        const_iterator & operator--() { --it_; return *this; }
+        const_iterator operator++(int) { const_iterator r(*this); ++it_; return r; }
+        const_iterator operator--(int) { const_iterator r(*this); --it_; return r; }
+        const_iterator & operator+=(difference_type n) { it_ += n; return *this; }
+        const_iterator & operator-=(difference_type n) { it_ -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(it_ + n, offset_); }
+        const_iterator operator-(difference_type n) const { return const_iterator(it_ - n, offset_); }
+        difference_type operator-(const_iterator const & rhs) const { return it_ - rhs.it_; }
+
+        bool operator==(const_iterator const & rhs) const { return it_ == rhs.it_; }
+        bool operator!=(const_iterator const & rhs) const { return it_ != rhs.it_; }
+        bool operator<(const_iterator const & rhs) const { return it_ < rhs.it_; }
+        bool operator>(const_iterator const & rhs) const { return it_ > rhs.it_; }
+        bool operator<=(const_iterator const & rhs) const { return it_ <= rhs.it_; }
+        bool operator>=(const_iterator const & rhs) const { return it_ >= rhs.it_; }
+
+    private:
+        twist const * it_;
+        unsigned int offset_;
+    };
+
+    pretzel_view(pretzel const & pr) : first_(pr.data()), last_(pr.data() + pr.size()), offset_(0) { }
+
+    // Requires that every twist in [first, last) have a strand number greater
+    // than offset.
+    pretzel_view(twist const * first, twist const * last, unsigned int offset)
+    : first_(first), last_(last), offset_(offset) { }
+
+    std::size_t size() const { return last_ - first_; }
+    bool empty() const { return first_ == last_; }
+
+    twist operator[](std::size_t i) const { return twist(first_[i].first - offset_, first_[i].second); }
+
+    const_iterator begin() const { return const_iterator(first_, offset_); }
+    const_iterator end() const { return const_iterator(last_, offset_); }
+
+    // The underlying twists, with their original strand numbers.
+    twist const * source_begin() const { return first_; }
+    twist const * source_end() const { return last_; }
+    unsigned int offset() const { return offset_; }
+
+    pretzel to_pretzel() const { return pretzel(begin(), end()); }
+
+private:
+    twist const * first_;
+    twist const * last_;
+    unsigned int offset_;
+};
 
 // Formatted input. If parsing succeeds, returns true and overwrites *out with
 // the parsed pretzel data. If parsing fails, returns false and *out is not
@@ -103,6 +188,6 @@ std::basic_ostream<CharT, Traits> & operator<<(std::basic_ostream<CharT, Traits>
 
 // Pretty-print the pretzel to the given output stream, with an optional
 // per-line prefix.
-void print_pretzel(pretzel const & pr, std::ostream & os, const char * prefix = "");
+void print_pretzel(pretzel_view pr, std::ostream & os, const char * prefix = "");
 
 #endif
@@ -48,6 +48,22 @@ void TestPretzel()
     EXPECT_EQ(pr, expected);
 }
 
+void TestOutOfRange()
+{
+    pretzel pr, expected{{1, 1}};
+    EXPECT_TRUE(parse_string_as_pretzel("A", &pr));
+
+    // Twisting numbers and strands must fit into an int.
+    EXPECT_FALSE(parse_string_as_pretzel("A4294967297", &pr));
+    EXPECT_FALSE(parse_string_as_pretzel("b-4294967297", &pr));
+    EXPECT_FALSE(parse_string_as_pretzel("1 -4294967296", &pr));
+    EXPECT_EQ(pr, expected);
+
+    pretzel big{{1, 2147483647}};
+    EXPECT_TRUE(parse_string_as_pretzel("A2147483647", &pr));
+    EXPECT_EQ(pr, big);
+}
+
 int main()
 {
     TestPrinting();
@@ -55,4 +71,5 @@ int main()
     TestNumeric();
     TestBraid();
     TestPretzel();
+    TestOutOfRange();
 }
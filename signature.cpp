@@ -0,0 +1,139 @@
+#include <cmath>
+#include <utility>
+
+#include "signature.hpp"
+
+namespace
+{
+    __extension__ typedef __int128 int128;
+
+    template <typename T>
+    int sign_of(T const & x) { return x < T(0) ? -1 : T(0) < x ? 1 : 0; }
+
+    // Simultaneously swaps rows and columns i and j, which is a congruence.
+    template <typename T>
+    void swap_symmetric(square_matrix<T> & a, std::size_t i, std::size_t j)
+    {
+        if (i == j) { return; }
+        for (std::size_t l = 0; l != a.dim(); ++l) { std::swap(a(i, l), a(j, l)); }
+        for (std::size_t l = 0; l != a.dim(); ++l) { std::swap(a(l, i), a(l, j)); }
+    }
+
+    template <typename T>
+    signature_result diagonalise(square_matrix<int> const & sm)
+    // Fraction-free (Bareiss) elimination of A = M + M*, with symmetric
+    // pivoting so that every step is a congruence. After k steps, the entries
+    // of the trailing submatrix are (k + 1) x (k + 1) minors of A, and "prev"
+    // is the leading k x k minor D_k. The ratios D_k / D_{k-1} form a diagonal
+    // matrix congruent to the eliminated part, so each step contributes the
+    // sign of D_k D_{k-1} to the signature (Jacobi's rule).
+    //
+    // If all remaining diagonal entries are zero but some off-diagonal entry b
+    // is not, we eliminate a 2 x 2 block [0 b; b 0] at once, by the two-step
+    // form of Sylvester's identity. Such a block has eigenvalues b and -b and
+    // contributes zero to the signature. If the remaining submatrix is zero,
+    // its dimension is the nullity.
+    {
+        std::size_t const n = sm.dim();
+
+        square_matrix<T> a(n);
+        for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                a(i, j) = T(static_cast<long int>(sm(i, j)) + sm(j, i));
+
+        signature_result result = { 0, 0, bigint() };
+        T prev(1);
+        std::size_t k = 0;
+
+        while (k != n)
+        {
+            std::size_t p = k;
+            while (p != n && a(p, p) == T(0)) { ++p; }
+
+            if (p != n)
+            {
+                swap_symmetric(a, k, p);
+                T const pivot = a(k, k);
+
+                for (std::size_t i = k + 1; i != n; ++i)
+                {
+                    for (std::size_t j = i; j != n; ++j)
+                    {
+                        a(i, j) = (pivot * a(i, j) - a(i, k) * a(k, j)) / prev;
+                        a(j, i) = a(i, j);
+                    }
+                }
+
+                result.signature += sign_of(pivot) == sign_of(prev) ? 1 : -1;
+                prev = pivot;
+                k += 1;
+                continue;
+            }
+
+            std::size_t q = n;
+            for (p = k; p != n; ++p)
+            {
+                for (q = p + 1; q != n && a(p, q) == T(0); ++q) { }
+                if (q != n) { break; }
+            }
+
+            if (p == n) { break; }
+
+            swap_symmetric(a, k, p);
+            swap_symmetric(a, k + 1, q);
+            T const b = a(k, k + 1);
+
+            // The 3 x 3 minor with rows k, k + 1, i and columns k, k + 1, j is
+            // b (a_kj a_i,k+1 + a_k+1,j a_ik - b a_ij), and D_k^2 divides it.
+            for (std::size_t i = k + 2; i != n; ++i)
+            {
+                for (std::size_t j = i; j != n; ++j)
+                {
+                    T const t = a(k, j) * a(i, k + 1) + a(k + 1, j) * a(i, k) - b * a(i, j);
+                    a(i, j) = b * t / prev / prev;
+                    a(j, i) = a(i, j);
+                }
+            }
+
+            prev = -(b * b) / prev;
+            k += 2;
+        }
+
+        result.nullity = n - k;
+        if (k == n) { result.determinant = bigint(prev < T(0) ? -prev : prev); }
+        return result;
+    }
+
+    // Returns log2 of Hadamard's bound H for the minors of M + M*, i.e. of the
+    // product of the Euclidean norms of its rows (or 1, if a norm is less than
+    // 1). The values in diagonalise() are bounded by 3 H^3.
+    double hadamard_bits(square_matrix<int> const & sm)
+    {
+        double h = 0;
+        for (std::size_t i = 0; i != sm.dim(); ++i)
+        {
+            double norm2 = 0;
+            for (std::size_t j = 0; j != sm.dim(); ++j)
+            {
+                double const e = static_cast<double>(sm(i, j)) + sm(j, i);
+                norm2 += e * e;
+            }
+            if (norm2 > 1) { h += std::log2(norm2) / 2; }
+        }
+        return h;
+    }
+}
+
+signature_result compute_signature(square_matrix<int> const & sm)
+{
+    double const bits = 3 * hadamard_bits(sm) + 2;
+
+    if (bits < 62)  { return diagonalise<long int>(sm); }
+    if (bits < 126) { return diagonalise<int128>(sm); }
+    return diagonalise<bigint>(sm);
+}
+
+signature_result compute_signature(sparse_matrix<int> const & sm)
+{
+    return compute_signature(square_matrix<int>(sm.to_dense()));
+}
@@ -0,0 +1,43 @@
+// The signature, nullity and determinant of a link from its Seifert matrix.
+//
+// If M is a Seifert matrix of a link L, then the symmetric matrix M + M* (where
+// M* is the transpose of M) determines the following invariants:
+//
+//    - the signature of L is the signature of M + M*, i.e. the number of its
+//      positive eigenvalues minus the number of its negative ones;
+//
+//    - the nullity of L is the dimension of the kernel of M + M* (for a
+//      connected Seifert surface);
+//
+//    - the determinant of L is |det(M + M*)| = |p(-1)|, where p is the
+//      Alexander polynomial (see alexander.hpp).
+//
+// All three come out of a single exact congruence diagonalisation of M + M*,
+// in O(d^3) operations for a matrix of dimension d, which is much cheaper than
+// computing the Alexander polynomial.
+
+#ifndef H_SIGNATURE
+#define H_SIGNATURE
+
+#include <cstddef>
+
+#include "bigint.hpp"
+#include "matrix.hpp"
+#include "sparse_matrix.hpp"
+
+struct signature_result
+{
+    long int signature;
+    std::size_t nullity;
+    bigint determinant;   // non-negative
+};
+
+// Computes the signature, nullity and determinant of M + M*, where M is the
+// given Seifert matrix. The arithmetic is exact, in the narrowest integer type
+// that a bound on the intermediate values permits (cf. exact_width()).
+signature_result compute_signature(square_matrix<int> const & sm);
+
+// The same for a sparse Seifert matrix, which is expanded to a dense one.
+signature_result compute_signature(sparse_matrix<int> const & sm);
+
+#endif
@@ -0,0 +1,169 @@
+#include <cstdlib>
+#include <initializer_list>
+#include <random>
+
+#include "alexander.hpp"
+#include "signature.hpp"
+#include "testing.hpp"
+
+namespace
+{
+    square_matrix<int> make_matrix(std::initializer_list<std::initializer_list<int>> rows)
+    {
+        square_matrix<int> m(rows.size());
+        std::size_t i = 0;
+        for (auto const & row : rows)
+        {
+            std::size_t j = 0;
+            for (int x : row) { m(i, j++) = x; }
+            ++i;
+        }
+        return m;
+    }
+
+    // |p(-1)|, from the coefficients of det(t M - M*).
+    bigint determinant_from_alexander(square_matrix<int> const & sm)
+    {
+        alexander_polynomial const coeffs = alexander_poly(sm, alexander_engine::exact);
+        bigint value;
+        for (std::size_t k = 0; k != coeffs.size(); ++k) { value += k % 2 ? -coeffs[k] : coeffs[k]; }
+        return value < bigint(0) ? -value : value;
+    }
+
+    // A Seifert matrix M such that M + M* is congruent to the diagonal matrix
+    // with the given (even) entries, via random unimodular row operations.
+    square_matrix<int> congruent_to(std::vector<int> const & diagonal, std::mt19937 & rng)
+    {
+        std::size_t const n = diagonal.size();
+        square_matrix<int> s(n);
+        for (std::size_t i = 0; i != n; ++i) { s(i, i) = diagonal[i]; }
+
+        // Add row and column j to row and column i, keeping the entries small.
+        for (int step = 0; step != int(4 * n); ++step)
+        {
+            std::size_t const i = rng() % n, j = rng() % n;
+            if (i == j) { continue; }
+            int const c = rng() % 2 ? 1 : -1;
+            for (std::size_t l = 0; l != n; ++l) { s(i, l) += c * s(j, l); }
+            for (std::size_t l = 0; l != n; ++l) { s(l, i) += c * s(l, j); }
+        }
+
+        square_matrix<int> m(n);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            m(i, i) = s(i, i) / 2;
+            for (std::size_t j = i + 1; j != n; ++j) { m(i, j) = s(i, j); }
+        }
+        return m;
+    }
+}
+
+void TestSmallKnots()
+{
+    // Trefoil "AAA".
+    signature_result trefoil = compute_signature(make_matrix({{-1, 0}, {1, -1}}));
+    EXPECT_EQ(trefoil.signature, -2);
+    EXPECT_EQ(trefoil.nullity, 0u);
+    EXPECT_EQ(trefoil.determinant, bigint(3));
+
+    // Figure eight knot "AbAb".
+    signature_result figure_eight = compute_signature(make_matrix({{-1, 1}, {0, 1}}));
+    EXPECT_EQ(figure_eight.signature, 0);
+    EXPECT_EQ(figure_eight.determinant, bigint(5));
+
+    // Pretzel "A3B5C7".
+    signature_result pretzel = compute_signature(make_matrix({{-5, 1}, {0, 7}}));
+    EXPECT_EQ(pretzel.signature, 0);
+    EXPECT_EQ(pretzel.determinant, bigint(141));
+
+    // Empty Seifert matrix (the unknot).
+    signature_result unknot = compute_signature(square_matrix<int>(0));
+    EXPECT_EQ(unknot.signature, 0);
+    EXPECT_EQ(unknot.nullity, 0u);
+    EXPECT_EQ(unknot.determinant, bigint(1));
+}
+
+void TestZeroDiagonal()
+{
+    // M + M* = [0 1; 1 0] needs a 2 x 2 pivot.
+    signature_result hyperbolic = compute_signature(make_matrix({{0, 1}, {0, 0}}));
+    EXPECT_EQ(hyperbolic.signature, 0);
+    EXPECT_EQ(hyperbolic.nullity, 0u);
+    EXPECT_EQ(hyperbolic.determinant, bigint(1));
+
+    // Two such blocks, interleaved.
+    signature_result two = compute_signature(make_matrix({{0, 0, 2, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 1, 0, 0}}));
+    EXPECT_EQ(two.signature, 0);
+    EXPECT_EQ(two.nullity, 0u);
+    EXPECT_EQ(two.determinant, bigint(4));
+
+    // A 2 x 2 pivot after an ordinary one, and before another: [2] plus the
+    // 3 x 3 matrix with zero diagonal and ones elsewhere.
+    signature_result after = compute_signature(make_matrix({{1, 0, 0, 0}, {0, 0, 1, 1}, {0, 0, 0, 1}, {0, 0, 0, 0}}));
+    EXPECT_EQ(after.signature, 0);
+    EXPECT_EQ(after.nullity, 0u);
+    EXPECT_EQ(after.determinant, bigint(4));
+
+    // A definite block and a kernel.
+    signature_result degenerate = compute_signature(make_matrix({{0, 0, 0}, {0, 1, 0}, {0, 0, 0}}));
+    EXPECT_EQ(degenerate.signature, 1);
+    EXPECT_EQ(degenerate.nullity, 2u);
+    EXPECT_EQ(degenerate.determinant, bigint(0));
+
+    signature_result zero = compute_signature(square_matrix<int>(3));
+    EXPECT_EQ(zero.signature, 0);
+    EXPECT_EQ(zero.nullity, 3u);
+    EXPECT_EQ(zero.determinant, bigint(0));
+}
+
+void TestCongruence()
+{
+    std::mt19937 rng(1);
+    for (int trial = 0; trial != 200; ++trial)
+    {
+        std::vector<int> diagonal(rng() % 8 + 1);
+        long int expected_signature = 0;
+        std::size_t expected_nullity = 0;
+        bigint expected_determinant = 1;
+        for (int & d : diagonal)
+        {
+            d = 2 * (int(rng() % 5) - 2);
+            expected_signature += d > 0 ? 1 : d < 0 ? -1 : 0;
+            expected_nullity += d == 0;
+            expected_determinant *= std::abs(d);
+        }
+
+        signature_result r = compute_signature(congruent_to(diagonal, rng));
+        EXPECT_EQ(r.signature, expected_signature);
+        EXPECT_EQ(r.nullity, expected_nullity);
+        EXPECT_EQ(r.determinant, expected_determinant);
+    }
+}
+
+void TestAgainstAlexander()
+{
+    // The determinant is |p(-1)|, including for dimensions that need 128-bit
+    // and arbitrary-precision arithmetic.
+    std::mt19937 rng(2);
+    for (std::size_t d : { 3, 10, 25, 40 })
+    {
+        square_matrix<int> m(d);
+        for (std::size_t i = 0; i != d; ++i)
+        {
+            m(i, i) = int(rng() % 7) - 3;
+            if (i + 1 != d) { m(i, i + 1) = int(rng() % 3) - 1; m(i + 1, i) = int(rng() % 2); }
+            if (i + 3 < d)  { m(i + 3, i) = int(rng() % 2); }
+        }
+        signature_result r = compute_signature(m);
+        EXPECT_EQ(r.determinant, determinant_from_alexander(m));
+        EXPECT_EQ(compute_signature(sparse_matrix<int>(m)).signature, r.signature);
+    }
+}
+
+int main()
+{
+    TestSmallKnots();
+    TestZeroDiagonal();
+    TestCongruence();
+    TestAgainstAlexander();
+}
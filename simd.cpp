@@ -0,0 +1,84 @@
+#include "simd.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    using kernel = void (*)(double *, double const *, double, std::size_t);
+
+    void subtract_scaled_scalar(double * y, double const * x, double a, std::size_t n)
+    {
+        for (std::size_t i = 0; i != n; ++i) { y[i] -= a * x[i]; }
+    }
+
+#ifdef SIMD_X86
+    __attribute__((target("avx2")))
+    void subtract_scaled_avx2(double * y, double const * x, double a, std::size_t n)
+    {
+        __m256d const va = _mm256_set1_pd(a);
+
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256d y0 = _mm256_loadu_pd(y + i), y1 = _mm256_loadu_pd(y + i + 4);
+            y0 = _mm256_sub_pd(y0, _mm256_mul_pd(va, _mm256_loadu_pd(x + i)));
+            y1 = _mm256_sub_pd(y1, _mm256_mul_pd(va, _mm256_loadu_pd(x + i + 4)));
+            _mm256_storeu_pd(y + i, y0);
+            _mm256_storeu_pd(y + i + 4, y1);
+        }
+        for (; i != n; ++i) { y[i] -= a * x[i]; }
+    }
+
+    __attribute__((target("avx512f")))
+    void subtract_scaled_avx512(double * y, double const * x, double a, std::size_t n)
+    {
+        __m512d const va = _mm512_set1_pd(a);
+
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m512d y0 = _mm512_loadu_pd(y + i);
+            y0 = _mm512_sub_pd(y0, _mm512_mul_pd(va, _mm512_loadu_pd(x + i)));
+            _mm512_storeu_pd(y + i, y0);
+        }
+        if (i != n)
+        {
+            __mmask8 const mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+            __m512d y0 = _mm512_maskz_loadu_pd(mask, y + i);
+            y0 = _mm512_sub_pd(y0, _mm512_mul_pd(va, _mm512_maskz_loadu_pd(mask, x + i)));
+            _mm512_mask_storeu_pd(y + i, mask, y0);
+        }
+    }
+#endif
+
+    struct selection
+    {
+        kernel fn;
+        char const * name;
+    };
+
+    selection select_kernel()
+    {
+#ifdef SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) { return { subtract_scaled_avx512, "avx512" }; }
+        if (__builtin_cpu_supports("avx2"))    { return { subtract_scaled_avx2,   "avx2"   }; }
+#endif
+        return { subtract_scaled_scalar, "scalar" };
+    }
+
+    selection const selected = select_kernel();
+}
+
+void matrix_detail::subtract_scaled(double * y, double const * x, double a, std::size_t n)
+{
+    selected.fn(y, x, a, n);
+}
+
+char const * simd_kernel_name()
+{
+    return selected.name;
+}
@@ -0,0 +1,25 @@
+// Vectorised row operation kernels for the elimination of matrices of doubles
+// (see matrix.hpp).
+//
+// The kernel is selected once at run time according to the capabilities of
+// the CPU: AVX-512, AVX2 or portable scalar code. All kernels perform the same,
+// separately rounded operations (in particular, no fused multiply-add), so
+// that their results are identical and do not depend on the machine. This
+// requires that the compiler not contract them either (-ffp-contract=off).
+
+#ifndef H_SIMD
+#define H_SIMD
+
+#include <cstddef>
+
+namespace matrix_detail
+{
+    // Computes y[i] -= a * x[i] for i in [0, n). The ranges may be unaligned
+    // but must not overlap.
+    void subtract_scaled(double * y, double const * x, double a, std::size_t n);
+}
+
+// Returns the name of the selected kernel: "avx512", "avx2" or "scalar".
+char const * simd_kernel_name();
+
+#endif
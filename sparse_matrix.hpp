@@ -0,0 +1,407 @@
+// A sparse matrix class template: sparse_matrix<T>
+//
+//    std::vector<sparse_matrix<double>::entry> es = { { 0, 0, 2.0 }, { 1, 1, 3.0 } };
+//    sparse_matrix<double> m(2, 2, es);
+//    double d = m.determinant();          // d == 6
+//
+// Only the non-zero entries are stored, row by row in order of increasing
+// column (compressed sparse row format). Sums, scalar multiples and the
+// transpose take time proportional to the number of non-zero entries.
+//
+// The determinant of a square sparse matrix over a field (see matrix.hpp for
+// the classification of number types) is computed by sparse LU
+// decomposition. The pivots are chosen to limit fill-in (Markowitz's
+// strategy, restricted to the columns with the fewest entries), so that the
+// factors of the very sparse matrices that arise from Seifert surfaces stay
+// sparse. Inexact types additionally require a pivot of at least a tenth of
+// the largest magnitude in its column (threshold pivoting).
+
+#ifndef H_SPARSE_MATRIX
+#define H_SPARSE_MATRIX
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arena.hpp"
+#include "contract.hpp"
+#include "matrix.hpp"
+
+template <typename T>
+class sparse_matrix
+{
+    template <typename> friend class sparse_matrix;
+
+public:
+    struct entry
+    {
+        std::size_t row;
+        std::size_t col;
+        T value;
+    };
+
+    explicit sparse_matrix(std::size_t rows, std::size_t cols)
+    : rows_(rows)
+    , cols_(cols)
+    , row_start_(rows + 1, 0)
+    { }
+
+    // Constructs a matrix from a list of entries in any order. Entries at the
+    // same position are added up, and zero entries are not stored.
+    template <typename A>
+    explicit sparse_matrix(std::size_t rows, std::size_t cols, std::vector<entry, A> entries)
+    : sparse_matrix(rows, cols)
+    {
+        std::sort(entries.begin(), entries.end(), [](entry const & x, entry const & y)
+                  { return x.row != y.row ? x.row < y.row : x.col < y.col; });
+
+        for (auto it = entries.begin(); it != entries.end(); )
+        {
+            CHECK(it->row < rows_ && it->col < cols_, "Sparse matrix entry out of range!");
+
+            entry const & e = *it;
+            T value = e.value;
+            for (++it; it != entries.end() && it->row == e.row && it->col == e.col; ++it) { value += it->value; }
+
+            if (!(value == T(0)))
+            {
+                ++row_start_[e.row + 1];
+                col_index_.push_back(e.col);
+                values_.push_back(value);
+            }
+        }
+        std::partial_sum(row_start_.begin(), row_start_.end(), row_start_.begin());
+    }
+
+    // Converts the non-zero entries of a dense matrix.
+    explicit sparse_matrix(matrix<T> const & m)
+    : sparse_matrix(m.rows(), m.cols())
+    {
+        for (std::size_t i = 0; i != rows_; ++i)
+        {
+            for (std::size_t j = 0; j != cols_; ++j)
+            {
+                if (m(i, j) == T(0)) { continue; }
+                col_index_.push_back(j);
+                values_.push_back(m(i, j));
+            }
+            row_start_[i + 1] = col_index_.size();
+        }
+    }
+
+    // Converts the number type (entries that become zero are dropped).
+    template <typename S>
+    explicit sparse_matrix(sparse_matrix<S> const & m)
+    : sparse_matrix(m.rows(), m.cols())
+    {
+        col_index_.reserve(m.nonzeros());
+        values_.reserve(m.nonzeros());
+        for (std::size_t i = 0; i != rows_; ++i)
+        {
+            for (std::size_t k = m.row_start_[i]; k != m.row_start_[i + 1]; ++k)
+                push_entry(m.col_index_[k], T(m.values_[k]));
+            row_start_[i + 1] = col_index_.size();
+        }
+    }
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t nonzeros() const { return values_.size(); }
+
+    // The non-zero entries of row i are at the positions k in the range
+    // [row_begin(i), row_end(i)), in order of increasing column col(k); their
+    // values are value(k).
+    std::size_t row_begin(std::size_t i) const { assert(i < rows_); return row_start_[i]; }
+    std::size_t row_end(std::size_t i) const { assert(i < rows_); return row_start_[i + 1]; }
+    std::size_t col(std::size_t k) const { return col_index_[k]; }
+    T const & value(std::size_t k) const { return values_[k]; }
+
+    // Returns the entry in row i and column j (which may be zero).
+    T operator()(std::size_t i, std::size_t j) const
+    {
+        assert(i < rows_ && j < cols_);
+
+        auto first = col_index_.begin() + row_start_[i], last = col_index_.begin() + row_start_[i + 1];
+        auto it = std::lower_bound(first, last, j);
+        return it != last && *it == j ? values_[it - col_index_.begin()] : T(0);
+    }
+
+    matrix<T> to_dense() const
+    {
+        matrix<T> result(rows_, cols_, T(0));
+        for (std::size_t i = 0; i != rows_; ++i)
+            for (std::size_t k = row_start_[i]; k != row_start_[i + 1]; ++k)
+                result(i, col_index_[k]) = values_[k];
+        return result;
+    }
+
+    sparse_matrix transpose() const
+    {
+        sparse_matrix result(cols_, rows_);
+        result.col_index_.resize(nonzeros());
+        result.values_.resize(nonzeros());
+
+        for (std::size_t c : col_index_) { ++result.row_start_[c + 1]; }
+        std::partial_sum(result.row_start_.begin(), result.row_start_.end(), result.row_start_.begin());
+
+        // Going through the rows in order leaves each new row sorted.
+        scratch_vector<std::size_t> next(result.row_start_.begin(), result.row_start_.end() - 1);
+        for (std::size_t i = 0; i != rows_; ++i)
+        {
+            for (std::size_t k = row_start_[i]; k != row_start_[i + 1]; ++k)
+            {
+                std::size_t const pos = next[col_index_[k]]++;
+                result.col_index_[pos] = i;
+                result.values_[pos] = values_[k];
+            }
+        }
+        return result;
+    }
+
+    sparse_matrix operator+(sparse_matrix const & rhs) const
+    {
+        CHECK(rows() == rhs.rows() && cols() == rhs.cols(), "Trying to add matrices of different sizes!");
+
+        sparse_matrix result(rows_, cols_);
+        result.col_index_.reserve(nonzeros() + rhs.nonzeros());
+        result.values_.reserve(nonzeros() + rhs.nonzeros());
+
+        for (std::size_t i = 0; i != rows_; ++i)
+        {
+            std::size_t k = row_start_[i], l = rhs.row_start_[i];
+            while (k != row_start_[i + 1] || l != rhs.row_start_[i + 1])
+            {
+                if (l == rhs.row_start_[i + 1] || (k != row_start_[i + 1] && col_index_[k] < rhs.col_index_[l]))
+                {
+                    result.push_entry(col_index_[k], values_[k]);
+                    ++k;
+                }
+                else if (k == row_start_[i + 1] || rhs.col_index_[l] < col_index_[k])
+                {
+                    result.push_entry(rhs.col_index_[l], rhs.values_[l]);
+                    ++l;
+                }
+                else
+                {
+                    result.push_entry(col_index_[k], values_[k] + rhs.values_[l]);
+                    ++k;
+                    ++l;
+                }
+            }
+            result.row_start_[i + 1] = result.col_index_.size();
+        }
+        return result;
+    }
+
+    sparse_matrix operator*(T const & x) const
+    {
+        sparse_matrix result(rows_, cols_);
+        for (std::size_t i = 0; i != rows_; ++i)
+        {
+            for (std::size_t k = row_start_[i]; k != row_start_[i + 1]; ++k)
+                result.push_entry(col_index_[k], values_[k] * x);
+            result.row_start_[i + 1] = result.col_index_.size();
+        }
+        return result;
+    }
+
+    // Sparse LU decomposition, see above. Requires division.
+    T determinant() const;
+
+private:
+    // Appends an entry to the last row, unless it is zero.
+    void push_entry(std::size_t c, T const & x)
+    {
+        if (x == T(0)) { return; }
+        col_index_.push_back(c);
+        values_.push_back(x);
+    }
+
+    std::size_t rows_;
+    std::size_t cols_;
+    scratch_vector<std::size_t> row_start_;   // size rows_ + 1
+    scratch_vector<std::size_t> col_index_;   // size nonzeros()
+    scratch_vector<T> values_;                // size nonzeros()
+};
+
+namespace matrix_detail
+{
+    // Whether x is admissible as a pivot, given the largest magnitude in its
+    // column. Exact types admit any non-zero entry.
+    template <typename T>
+    bool admissible_pivot(T const & x, T const & largest, std::false_type /* inexact */)
+    {
+        return std::abs(x) >= std::abs(largest) / 10;
+    }
+
+    template <typename T>
+    bool admissible_pivot(T const &, T const &, std::true_type /* exact */)
+    {
+        return true;
+    }
+
+    template <typename T>
+    T const & largest_magnitude(T const & x, T const & y, std::false_type /* inexact */)
+    {
+        return std::abs(x) < std::abs(y) ? y : x;
+    }
+
+    template <typename T>
+    T const & largest_magnitude(T const & x, T const &, std::true_type /* exact */)
+    {
+        return x;
+    }
+}
+
+template <typename T>
+T sparse_matrix<T>::determinant() const
+// We keep the active submatrix as sorted rows of (column, value) pairs, and
+// for every column the list of rows in which it is non-zero. In each step, we
+// take a column with the fewest entries and, among its admissible entries,
+// the one in the shortest row as the pivot, eliminate the column from the
+// other rows and drop the pivot row and column. The determinant is the
+// product of the pivots, up to the sign of the permutation that takes the
+// pivot rows to the pivot columns. The workspace is reallocated throughout,
+// so it lives on the free store rather than in an arena (see arena.hpp).
+{
+    static_assert(!std::numeric_limits<T>::is_integer,
+                  "LU decomposition can only be performed on a divisible number type.");
+    CHECK(rows_ == cols_, "Trying to compute the determinant of a non-square matrix!");
+
+    using exact = std::integral_constant<bool, std::numeric_limits<T>::is_exact>;
+    using row_type = std::vector<std::pair<std::size_t, T>>;
+
+    std::size_t const n = rows_;
+
+    std::vector<row_type> active_rows(n);
+    std::vector<std::vector<std::size_t>> col_rows(n);
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        active_rows[i].reserve(row_start_[i + 1] - row_start_[i]);
+        for (std::size_t k = row_start_[i]; k != row_start_[i + 1]; ++k)
+        {
+            active_rows[i].emplace_back(col_index_[k], values_[k]);
+            col_rows[col_index_[k]].push_back(i);
+        }
+    }
+
+    // The active columns, by number of entries.
+    std::set<std::pair<std::size_t, std::size_t>> by_count;
+    for (std::size_t j = 0; j != n; ++j) { by_count.emplace(col_rows[j].size(), j); }
+
+    auto find = [](row_type const & r, std::size_t c)
+    {
+        return std::lower_bound(r.begin(), r.end(), c, [](std::pair<std::size_t, T> const & x, std::size_t y)
+                                { return x.first < y; });
+    };
+    auto remove_row_from_col = [&](std::size_t k, std::size_t c)
+    {
+        std::vector<std::size_t> & rs = col_rows[c];
+        by_count.erase(std::make_pair(rs.size(), c));
+        *std::find(rs.begin(), rs.end(), k) = rs.back();
+        rs.pop_back();
+        by_count.emplace(rs.size(), c);
+    };
+    auto add_row_to_col = [&](std::size_t k, std::size_t c)
+    {
+        std::vector<std::size_t> & rs = col_rows[c];
+        by_count.erase(std::make_pair(rs.size(), c));
+        rs.push_back(k);
+        by_count.emplace(rs.size(), c);
+    };
+
+    T det(1);
+    std::vector<std::size_t> pivot_col_of_row(n);
+    row_type merged;
+
+    for (std::size_t step = 0; step != n; ++step)
+    {
+        std::size_t const c = by_count.begin()->second;
+        by_count.erase(by_count.begin());
+
+        std::vector<std::size_t> rs;
+        rs.swap(col_rows[c]);
+        if (rs.empty()) { return T(0); }
+
+        // Choose the pivot row.
+        T largest = find(active_rows[rs[0]], c)->second;
+        for (std::size_t k : rs)
+            largest = matrix_detail::largest_magnitude(largest, find(active_rows[k], c)->second, exact());
+
+        std::size_t r = n;
+        for (std::size_t k : rs)
+        {
+            if ((r == n || active_rows[k].size() < active_rows[r].size()) &&
+                matrix_detail::admissible_pivot(find(active_rows[k], c)->second, largest, exact()))
+            {
+                r = k;
+            }
+        }
+
+        row_type const pivot_row = std::move(active_rows[r]);
+        T const pivot = find(pivot_row, c)->second;
+        det *= pivot;
+        pivot_col_of_row[r] = c;
+
+        for (auto const & e : pivot_row)
+            if (e.first != c) { remove_row_from_col(r, e.first); }
+
+        // Eliminate column c from the other rows: row k -= (a_kc / pivot) * pivot row.
+        matrix_detail::divider<T> divide(pivot);
+        for (std::size_t k : rs)
+        {
+            if (k == r) { continue; }
+
+            row_type & row = active_rows[k];
+            T const factor = divide(find(row, c)->second);
+
+            merged.clear();
+            merged.reserve(row.size() + pivot_row.size());
+            auto it = row.begin();
+            for (auto const & e : pivot_row)
+            {
+                for (; it != row.end() && it->first < e.first; ++it) { merged.push_back(*it); }
+
+                if (it != row.end() && it->first == e.first)
+                {
+                    if (e.first != c)
+                    {
+                        T x = it->second - factor * e.second;
+                        if (x == T(0)) { remove_row_from_col(k, e.first); }
+                        else           { merged.emplace_back(e.first, std::move(x)); }
+                    }
+                    ++it;
+                }
+                else
+                {
+                    // Fill-in.
+                    merged.emplace_back(e.first, -(factor * e.second));
+                    add_row_to_col(k, e.first);
+                }
+            }
+            merged.insert(merged.end(), it, row.end());
+            row.swap(merged);
+        }
+    }
+
+    // The sign of the permutation i -> pivot_col_of_row[i].
+    std::vector<bool> visited(n, false);
+    bool odd = false;
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        if (visited[i]) { continue; }
+        std::size_t length = 0;
+        for (std::size_t k = i; !visited[k]; k = pivot_col_of_row[k]) { visited[k] = true; ++length; }
+        if (length % 2 == 0) { odd = !odd; }
+    }
+
+    return odd ? -det : det;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include <random>
+#include <vector>
+
+#include "matrix.hpp"
+#include "modular.hpp"
+#include "sparse_matrix.hpp"
+#include "testing.hpp"
+
+void TestConstruct()
+{
+    std::vector<sparse_matrix<int>::entry> entries = {
+        { 1, 2, 5 }, { 0, 1, 3 }, { 1, 2, 2 }, { 0, 0, 4 }, { 0, 0, -4 } };
+    sparse_matrix<int> m(2, 3, entries);
+
+    // Duplicates are added up, and zeros are dropped.
+    EXPECT_EQ(m.rows(), 2U);
+    EXPECT_EQ(m.cols(), 3U);
+    EXPECT_EQ(m.nonzeros(), 2U);
+    EXPECT_EQ(m(0, 0), 0); EXPECT_EQ(m(0, 1), 3); EXPECT_EQ(m(1, 2), 7);
+
+    matrix<int> dense = m.to_dense();
+    EXPECT_EQ(dense(0, 1), 3); EXPECT_EQ(dense(1, 2), 7); EXPECT_EQ(dense(1, 0), 0);
+
+    sparse_matrix<int> round_trip(dense);
+    EXPECT_EQ(round_trip.nonzeros(), 2U);
+    EXPECT_EQ(round_trip(1, 2), 7);
+}
+
+void TestArithmetic()
+{
+    std::vector<sparse_matrix<int>::entry> entries = { { 0, 1, 3 }, { 1, 0, 2 }, { 1, 1, 1 } };
+    sparse_matrix<int> m(2, 2, entries);
+
+    sparse_matrix<int> mt = m.transpose();
+    EXPECT_EQ(mt(1, 0), 3); EXPECT_EQ(mt(0, 1), 2); EXPECT_EQ(mt(1, 1), 1);
+
+    // m - m^T cancels the diagonal.
+    sparse_matrix<int> s = m + mt * -1;
+    EXPECT_EQ(s.nonzeros(), 2U);
+    EXPECT_EQ(s(0, 1), 1); EXPECT_EQ(s(1, 0), -1); EXPECT_EQ(s(1, 1), 0);
+}
+
+void TestDeterminant()
+{
+    EXPECT_EQ(sparse_matrix<double>(0, 0).determinant(), 1.0);
+
+    // A permutation matrix (a 3-cycle and a transposition) with weights.
+    std::vector<sparse_matrix<double>::entry> perm = {
+        { 0, 1, 2.0 }, { 1, 2, 3.0 }, { 2, 0, 5.0 }, { 3, 4, 7.0 }, { 4, 3, 1.0 } };
+    EXPECT_FLOAT_EQ(sparse_matrix<double>(5, 5, perm).determinant(), -210.0);
+
+    // A singular matrix.
+    std::vector<sparse_matrix<double>::entry> singular = {
+        { 0, 0, 1.0 }, { 0, 1, 2.0 }, { 1, 0, 2.0 }, { 1, 1, 4.0 }, { 2, 2, 1.0 } };
+    EXPECT_EQ(sparse_matrix<double>(3, 3, singular).determinant(), 0.0);
+
+    // Random sparse matrices agree with dense elimination.
+    std::mt19937 gen(4711);
+    std::uniform_int_distribution<int> pos(0, 39), val(-9, 9);
+    std::vector<sparse_matrix<int>::entry> entries;
+    for (std::size_t i = 0; i != 40; ++i) { entries.push_back({ i, i, 1 }); }
+    for (int k = 0; k != 80; ++k)
+    {
+        entries.push_back({ std::size_t(pos(gen)), std::size_t(pos(gen)), val(gen) });
+    }
+    sparse_matrix<int> const m(40, 40, entries);
+    square_matrix<int> const dense = m.to_dense();
+
+    double const det = square_matrix<double>(dense).determinant();
+    EXPECT_TRUE(std::abs(sparse_matrix<double>(m).determinant() - det) <= 1e-9 * std::abs(det));
+
+    modular::field_guard guard(1000003);
+    EXPECT_TRUE(sparse_matrix<modular>(m).determinant() == square_matrix<modular>(dense).determinant());
+}
+
+int main()
+{
+    TestConstruct();
+    TestArithmetic();
+    TestDeterminant();
+}